@@ -0,0 +1,62 @@
+"""In-process hook handlers (served by hook/scripts/hookd.py, see *.sh)."""
+
+import importlib.util
+import json
+import os
+import subprocess
+from datetime import date
+
+_transcript = None
+
+
+def _session_stats(event, ctx) -> str:
+    """ (so far: ...) for the reminder, from agent/scripts/transcript.py"""
+    global _transcript
+    path = event.get("transcript_path")
+    if not path or not os.path.isfile(path):
+        return ""
+    if _transcript is None:
+        spec = importlib.util.spec_from_file_location(
+            "transcript", os.path.join(ctx.zenix_root, "skills/system/agent/scripts/transcript.py"))
+        _transcript = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(_transcript)
+    try:
+        return f" (so far: {_transcript.summary_line(_transcript.stats(path))})"
+    except (OSError, ValueError):
+        return ""
+
+
+def _short_id(event) -> str:
+    return str(event.get("session_id") or "unknown")[:8]
+
+
+def _output(event_name: str, message: str) -> str:
+    return json.dumps({
+        "hookSpecificOutput": {"hookEventName": event_name, "message": message}
+    }, indent=2)
+
+
+def precompact(event, ctx):
+    return _output("PreCompact", (
+        "JOURNAL REMINDER: Context is about to be compacted. Write a brief summary "
+        f"of this session to vault/daily/{date.today():%Y-%m-%d}.md under ## Sessions. "
+        f"Include session ID [{_short_id(event)}]{_session_stats(event, ctx)} and key topics/decisions/outcomes. "
+        "Use Edit tool to append."))
+
+
+def session_end(event, ctx):
+    reason = event.get("trigger") or "unknown"
+
+    # Keep the session index current (agent/scripts/session-index.py)
+    transcript = event.get("transcript_path")
+    if transcript:
+        subprocess.Popen(
+            ["python3", os.path.join(ctx.zenix_root, "skills/system/agent/scripts/session-index.py"),
+             "update", transcript],
+            stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, start_new_session=True)
+    return _output("SessionEnd", (
+        f"JOURNAL: Session [{_short_id(event)}] ending ({reason}). If significant work "
+        f"was done, append summary to vault/daily/{date.today():%Y-%m-%d}.md"))
+
+
+HANDLERS = {"precompact": precompact, "session-end": session_end}
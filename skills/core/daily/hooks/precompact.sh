@@ -5,12 +5,21 @@
 # Read session info from stdin
 read -r INPUT
 SESSION_ID=$(echo "$INPUT" | jq -r '.session_id // "unknown"' 2>/dev/null | cut -c1-8)
+TRANSCRIPT=$(echo "$INPUT" | jq -r '.transcript_path // empty' 2>/dev/null)
+
+# Size of the session so far, read without loading the transcript
+STATS=""
+if [[ -f "$TRANSCRIPT" ]]; then
+    STATS=$(python3 "${ZENIX_ROOT:-${CLAUDE_PROJECT_DIR:-$HOME/.zenix}}/skills/system/agent/scripts/transcript.py" \
+        stats "$TRANSCRIPT" --line 2>/dev/null) || true
+    [[ -n "$STATS" ]] && STATS=" (so far: $STATS)"
+fi
 
 cat << EOF
 {
   "hookSpecificOutput": {
     "hookEventName": "PreCompact",
-    "message": "JOURNAL REMINDER: Context is about to be compacted. Write a brief summary of this session to vault/daily/$(date +%Y-%m-%d).md under ## Sessions. Include session ID [$SESSION_ID] and key topics/decisions/outcomes. Use Edit tool to append."
+    "message": "JOURNAL REMINDER: Context is about to be compacted. Write a brief summary of this session to vault/daily/$(date +%Y-%m-%d).md under ## Sessions. Include session ID [$SESSION_ID]$STATS and key topics/decisions/outcomes. Use Edit tool to append."
   }
 }
 EOF
@@ -6,6 +6,12 @@
 read -r INPUT
 SESSION_ID=$(echo "$INPUT" | jq -r '.session_id // "unknown"' 2>/dev/null | cut -c1-8)
 REASON=$(echo "$INPUT" | jq -r '.trigger // "unknown"' 2>/dev/null)
+TRANSCRIPT=$(echo "$INPUT" | jq -r '.transcript_path // empty' 2>/dev/null)
+
+# Keep the session index current (agent/scripts/session-index.py)
+if [[ -n "$TRANSCRIPT" ]]; then
+    nohup python3 "${ZENIX_ROOT:-${CLAUDE_PROJECT_DIR:-$HOME/.zenix}}/skills/system/agent/scripts/session-index.py" update "$TRANSCRIPT" >/dev/null 2>&1 &
+fi
 
 cat << EOF
 {
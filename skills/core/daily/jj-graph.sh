@@ -1,5 +1,5 @@
 #!/bin/bash
-# Append jj graph to today's daily log
+# Update the jj graph section of today's daily log
 # Run at end of day (manually or via cron)
 
 set -e
@@ -26,20 +26,27 @@ fi
 # Get jj graph
 JJ_GRAPH=$(jj log -r "::@" -n 15 2>/dev/null || echo "No jj repo")
 
-# Check if JJ Graph section exists
-if grep -q "## JJ Graph" "$DAILY_FILE"; then
-    # Remove old JJ Graph section and everything after it
-    sed -i '' '/^## JJ Graph/,$d' "$DAILY_FILE"
+# Replace the JJ Graph section (its heading and fenced block) in a temp
+# file next to the daily file and rename it over: readers and the vault
+# watchers never see a half-written file, and entries after it are kept
+SECTION=$(printf '## JJ Graph\n\n```\n%s\n```' "$JJ_GRAPH")
+TMP_FILE="$DAILY_FILE.$$.tmp"
+trap 'rm -f "$TMP_FILE"' EXIT
+
+# skip: 1 after the heading, 2 inside the old block, 3 after it
+SECTION="$SECTION" awk '
+    /^## JJ Graph[[:space:]]*$/ && !done { print ENVIRON["SECTION"]; skip = 1; done = 1; next }
+    skip == 2 { if (/^```/) skip = 3; next }
+    skip && /^[[:space:]]*$/ { next }
+    skip == 1 && /^```/ { skip = 2; next }
+    skip { skip = 0; print "" }
+    { print }
+    END { if (!done) { print ""; print ENVIRON["SECTION"] } }
+' "$DAILY_FILE" > "$TMP_FILE"
+
+if cmp -s "$TMP_FILE" "$DAILY_FILE"; then
+    echo "Unchanged $DAILY_FILE"
+else
+    mv -f "$TMP_FILE" "$DAILY_FILE"
+    echo "Updated $DAILY_FILE"
 fi
-
-# Append new JJ Graph section
-cat >> "$DAILY_FILE" << EOF
-
-## JJ Graph
-
-\`\`\`
-$JJ_GRAPH
-\`\`\`
-EOF
-
-echo "Updated $DAILY_FILE"
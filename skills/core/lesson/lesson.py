@@ -8,15 +8,19 @@ Pattern: WHEN [context] -> DO [action] -> BECAUSE [reason]
 import json
 import os
 import re
+import sqlite3
 import sys
+from contextlib import contextmanager
 from datetime import datetime
 from pathlib import Path
 from typing import Optional
 
 # Storage paths
+# lessons.jsonl is the source of truth (append-only); lessons.db is a
+# SQLite index over it, caught up incrementally from a byte offset.
 LESSONS_DIR = Path.home() / ".claude" / "lessons"
 LESSONS_FILE = LESSONS_DIR / "lessons.jsonl"
-INDEX_FILE = LESSONS_DIR / "index.json"
+DB_FILE = LESSONS_DIR / "lessons.db"
 
 # Pattern regex
 PATTERN_RE = re.compile(
@@ -24,36 +28,163 @@ PATTERN_RE = re.compile(
     re.IGNORECASE
 )
 
+SCHEMA = """
+CREATE TABLE IF NOT EXISTS lessons (
+    id     TEXT PRIMARY KEY,
+    num    INTEGER,
+    skill  TEXT,
+    source TEXT,
+    status TEXT,
+    data   TEXT NOT NULL
+);
+CREATE INDEX IF NOT EXISTS lessons_skill_status ON lessons(skill, status);
+CREATE INDEX IF NOT EXISTS lessons_status ON lessons(status, num);
+CREATE TABLE IF NOT EXISTS meta (key TEXT PRIMARY KEY, value TEXT);
+"""
+
+# Bytes of the log head remembered to detect a rewritten (not appended) file
+HEAD_BYTES = 256
+
 
 def ensure_storage():
     """Ensure storage directory exists."""
     LESSONS_DIR.mkdir(parents=True, exist_ok=True)
     if not LESSONS_FILE.exists():
         LESSONS_FILE.touch()
-    if not INDEX_FILE.exists():
-        INDEX_FILE.write_text("{}")
-
-
-def load_index() -> dict:
-    """Load the lesson index."""
-    ensure_storage()
-    try:
-        return json.loads(INDEX_FILE.read_text() or "{}")
-    except json.JSONDecodeError:
-        return {}
-
-
-def save_index(index: dict):
-    """Save the lesson index."""
-    INDEX_FILE.write_text(json.dumps(index, indent=2))
 
 
-def get_next_id(index: dict) -> str:
-    """Get next lesson ID."""
-    if not index:
-        return "001"
-    max_id = max(int(k) for k in index.keys() if k.isdigit())
-    return f"{max_id + 1:03d}"
+class LessonStore:
+    """SQLite index over lessons.jsonl: id lookup, skill/status indexes, FTS."""
+
+    def __init__(self):
+        ensure_storage()
+        self.db = sqlite3.connect(DB_FILE, timeout=10, isolation_level=None)
+        self.db.execute("PRAGMA journal_mode = WAL")
+        self.db.executescript(SCHEMA)
+        self.fts = self._init_fts()
+        # Readers only take the write lock when the log has grown
+        if LESSONS_FILE.stat().st_size != int(self._meta("offset") or 0):
+            with self.locked():
+                pass
+
+    def _init_fts(self) -> bool:
+        """Create the full-text table if this sqlite has FTS5."""
+        try:
+            self.db.execute("CREATE VIRTUAL TABLE IF NOT EXISTS lessons_fts USING fts5(id UNINDEXED, body)")
+            return True
+        except sqlite3.OperationalError:
+            return False
+
+    def _meta(self, key: str) -> str:
+        row = self.db.execute("SELECT value FROM meta WHERE key = ?", (key,)).fetchone()
+        return row[0] if row else ""
+
+    def _set_meta(self, key: str, value: str):
+        self.db.execute("INSERT INTO meta (key, value) VALUES (?, ?) "
+                        "ON CONFLICT(key) DO UPDATE SET value = excluded.value", (key, value))
+
+    @contextmanager
+    def locked(self):
+        """Write transaction, caught up with the log first."""
+        self.db.execute("BEGIN IMMEDIATE")
+        try:
+            self._sync()
+            yield
+            self.db.execute("COMMIT")
+        except BaseException:
+            self.db.execute("ROLLBACK")
+            raise
+
+    def _sync(self):
+        """Ingest log lines appended since the stored byte offset."""
+        size = LESSONS_FILE.stat().st_size
+        offset = int(self._meta("offset") or 0)
+        if size == offset:
+            return
+        with open(LESSONS_FILE, "rb") as f:
+            head = f.read(HEAD_BYTES).hex()
+            if size < offset or not head.startswith(self._meta("head")):
+                # Log was rewritten, not appended: rebuild
+                self.db.execute("DELETE FROM lessons")
+                if self.fts:
+                    self.db.execute("DELETE FROM lessons_fts")
+                offset = 0
+            f.seek(offset)
+            chunk = f.read(size - offset)
+        end = chunk.rfind(b"\n") + 1  # complete lines only
+        for line in chunk[:end].decode("utf-8", "replace").split("\n"):
+            if not line:
+                continue
+            try:
+                record = json.loads(line)
+            except json.JSONDecodeError:
+                continue
+            if isinstance(record, dict):
+                self._ingest(record)
+        offset += end
+        self._set_meta("offset", str(offset))
+        self._set_meta("head", head[:min(offset, HEAD_BYTES) * 2])
+
+    def _ingest(self, record: dict):
+        """New ids insert; later records (wrong/promote) update fields."""
+        lesson_id = str(record.get("id", ""))
+        if not lesson_id:
+            return
+        existing = self.get(lesson_id)
+        lesson = {**existing, **record} if existing else record
+        self.db.execute(
+            "INSERT INTO lessons (id, num, skill, source, status, data) VALUES (?, ?, ?, ?, ?, ?) "
+            "ON CONFLICT(id) DO UPDATE SET skill = excluded.skill, source = excluded.source, "
+            "status = excluded.status, data = excluded.data",
+            (lesson_id, int(lesson_id) if lesson_id.isdigit() else None,
+             lesson.get("skill", "global"), lesson.get("from"),
+             lesson.get("status", "active"), json.dumps(lesson)))
+        if self.fts and not existing:
+            body = f"{lesson.get('when', '')} {lesson.get('do', '')} {lesson.get('because', '')}"
+            self.db.execute("INSERT INTO lessons_fts (id, body) VALUES (?, ?)", (lesson_id, body))
+
+    def append(self, record: dict):
+        """Append to the log and index it (call inside locked())."""
+        with open(LESSONS_FILE, "a") as f:
+            f.write(json.dumps(record) + "\n")
+        self._sync()
+
+    def next_id(self) -> str:
+        row = self.db.execute("SELECT MAX(num) FROM lessons").fetchone()
+        return f"{(row[0] or 0) + 1:03d}"
+
+    def get(self, lesson_id: str) -> Optional[dict]:
+        row = self.db.execute("SELECT data FROM lessons WHERE id = ?", (lesson_id,)).fetchone()
+        return json.loads(row[0]) if row else None
+
+    def find(self, skill: Optional[str] = None, status: Optional[str] = "active",
+             source: Optional[str] = None) -> list:
+        where, params = [], []
+        for column, value in (("skill", skill), ("status", status), ("source", source)):
+            if value is not None:
+                where.append(f"{column} = ?")
+                params.append(value)
+        sql = "SELECT data FROM lessons"
+        if where:
+            sql += " WHERE " + " AND ".join(where)
+        return [json.loads(r[0]) for r in self.db.execute(sql + " ORDER BY num, id", params)]
+
+    def search(self, query: str, skill: Optional[str] = None) -> list:
+        """Active lessons matching every word of query (prefix match)."""
+        terms = re.findall(r"\w+", query)
+        if not self.fts or not terms:
+            # No FTS5 in this sqlite: substring scan of the active rows
+            q = query.lower()
+            return [l for l in self.find(skill=skill)
+                    if q in f"{l.get('when', '')} {l.get('do', '')} {l.get('because', '')}".lower()]
+
+        sql = ("SELECT l.data FROM lessons_fts f JOIN lessons l ON l.id = f.id "
+               "WHERE lessons_fts MATCH ? AND l.status = 'active'")
+        params = [" AND ".join(f'"{t}"*' for t in terms)]
+        if skill:
+            sql += " AND l.skill = ?"
+            params.append(skill)
+        return [json.loads(r[0]) for r in self.db.execute(sql + " ORDER BY l.num", params)]
 
 
 def parse_pattern(text: str) -> Optional[dict]:
@@ -82,28 +213,6 @@ def detect_source() -> str:
     return "ai"
 
 
-def append_lesson(lesson: dict):
-    """Append lesson to JSONL file."""
-    ensure_storage()
-    with open(LESSONS_FILE, "a") as f:
-        f.write(json.dumps(lesson) + "\n")
-
-
-def get_all_lessons() -> list:
-    """Get all lessons from JSONL, latest entry per ID wins."""
-    ensure_storage()
-    lessons = {}
-    if LESSONS_FILE.exists():
-        for line in LESSONS_FILE.read_text().strip().split("\n"):
-            if line:
-                try:
-                    lesson = json.loads(line)
-                    lessons[lesson["id"]] = lesson
-                except json.JSONDecodeError:
-                    continue
-    return list(lessons.values())
-
-
 def cmd_add(pattern: str, skill: str = "global"):
     """Add a new lesson."""
     parsed = parse_pattern(pattern)
@@ -112,29 +221,20 @@ def cmd_add(pattern: str, skill: str = "global"):
         print("Expected: WHEN [context] -> DO [action] -> BECAUSE [reason]", file=sys.stderr)
         sys.exit(1)
 
-    index = load_index()
-    lesson_id = get_next_id(index)
     source = detect_source()
-
-    lesson = {
-        "id": lesson_id,
-        "skill": skill,
-        "from": source,
-        "status": "active",
-        "created": datetime.now().isoformat()[:10],
-        **parsed,
-    }
-
-    # Update index
-    index[lesson_id] = {
-        "skill": skill,
-        "status": "active",
-        "from": source,
-    }
-    save_index(index)
-
-    # Append to log
-    append_lesson(lesson)
+    store = LessonStore()
+
+    # Allocate the id and append under one lock
+    with store.locked():
+        lesson_id = store.next_id()
+        store.append({
+            "id": lesson_id,
+            "skill": skill,
+            "from": source,
+            "status": "active",
+            "created": datetime.now().isoformat()[:10],
+            **parsed,
+        })
 
     print(f"Added lesson {lesson_id} ({source}): {pattern[:60]}...")
 
@@ -142,17 +242,9 @@ def cmd_add(pattern: str, skill: str = "global"):
 def cmd_list(skill: Optional[str] = None, from_filter: Optional[str] = None,
              show_all: bool = False, global_only: bool = False):
     """List lessons."""
-    lessons = get_all_lessons()
-
-    # Filter
-    if not show_all:
-        lessons = [l for l in lessons if l.get("status") == "active"]
-    if skill:
-        lessons = [l for l in lessons if l.get("skill") == skill]
     if global_only:
-        lessons = [l for l in lessons if l.get("skill") == "global"]
-    if from_filter:
-        lessons = [l for l in lessons if l.get("from") == from_filter]
+        skill = "global"
+    lessons = LessonStore().find(skill=skill, status=None if show_all else "active", source=from_filter)
 
     if not lessons:
         print("No lessons found.")
@@ -162,7 +254,7 @@ def cmd_list(skill: Optional[str] = None, from_filter: Optional[str] = None,
     print(f"{'ID':<5} {'SKILL':<10} {'FROM':<6} PATTERN")
     print("-" * 60)
 
-    for l in sorted(lessons, key=lambda x: x["id"]):
+    for l in lessons:
         action = "DO NOT" if l.get("action") == "dont" else "DO"
         pattern = f"WHEN {l['when']} -> {action} {l['do']} -> BECAUSE {l['because']}"
         status = "" if l.get("status") == "active" else f" [{l.get('status')}]"
@@ -171,8 +263,7 @@ def cmd_list(skill: Optional[str] = None, from_filter: Optional[str] = None,
 
 def cmd_show(lesson_id: str):
     """Show lesson details."""
-    lessons = get_all_lessons()
-    lesson = next((l for l in lessons if l["id"] == lesson_id), None)
+    lesson = LessonStore().get(lesson_id)
 
     if not lesson:
         print(f"Lesson {lesson_id} not found.", file=sys.stderr)
@@ -195,16 +286,12 @@ def cmd_show(lesson_id: str):
 
 def cmd_wrong(lesson_id: str, reason: Optional[str] = None):
     """Mark lesson as incorrect (delete)."""
-    index = load_index()
+    store = LessonStore()
 
-    if lesson_id not in index:
+    if not store.get(lesson_id):
         print(f"Lesson {lesson_id} not found.", file=sys.stderr)
         sys.exit(1)
 
-    # Update index
-    index[lesson_id]["status"] = "deleted"
-    save_index(index)
-
     # Append deletion record
     deletion = {
         "id": lesson_id,
@@ -213,15 +300,16 @@ def cmd_wrong(lesson_id: str, reason: Optional[str] = None):
     }
     if reason:
         deletion["reason"] = reason
-    append_lesson(deletion)
+    with store.locked():
+        store.append(deletion)
 
     print(f"Deleted lesson {lesson_id}" + (f" ({reason})" if reason else ""))
 
 
 def cmd_promote(lesson_id: str, to_skill: str):
     """Promote lesson to skill's SKILL.md."""
-    lessons = get_all_lessons()
-    lesson = next((l for l in lessons if l["id"] == lesson_id), None)
+    store = LessonStore()
+    lesson = store.get(lesson_id)
 
     if not lesson:
         print(f"Lesson {lesson_id} not found.", file=sys.stderr)
@@ -262,39 +350,21 @@ def cmd_promote(lesson_id: str, to_skill: str):
 
     skill_md.write_text(content)
 
-    # Update index
-    index = load_index()
-    index[lesson_id]["status"] = "promoted"
-    index[lesson_id]["promoted_to"] = to_skill
-    save_index(index)
-
     # Append promotion record
-    append_lesson({
-        "id": lesson_id,
-        "status": "promoted",
-        "promoted_to": to_skill,
-        "updated": datetime.now().isoformat()[:10],
-    })
+    with store.locked():
+        store.append({
+            "id": lesson_id,
+            "status": "promoted",
+            "promoted_to": to_skill,
+            "updated": datetime.now().isoformat()[:10],
+        })
 
     print(f"Promoted lesson {lesson_id} to {to_skill}/SKILL.md")
 
 
 def cmd_search(query: str, skill: Optional[str] = None):
     """Search lessons."""
-    lessons = get_all_lessons()
-    query_lower = query.lower()
-
-    results = []
-    for l in lessons:
-        if l.get("status") != "active":
-            continue
-        if skill and l.get("skill") != skill:
-            continue
-
-        # Search in pattern fields
-        searchable = f"{l.get('when', '')} {l.get('do', '')} {l.get('because', '')}".lower()
-        if query_lower in searchable:
-            results.append(l)
+    results = LessonStore().search(query, skill)
 
     if not results:
         print(f"No lessons matching '{query}'")
@@ -309,11 +379,11 @@ def cmd_search(query: str, skill: Optional[str] = None):
 
 def cmd_load(skill: str):
     """Load lessons for a skill (for embedding in SKILL.md)."""
-    lessons = get_all_lessons()
+    store = LessonStore()
 
-    # Get global + skill-specific lessons
-    global_lessons = [l for l in lessons if l.get("skill") == "global" and l.get("status") == "active"]
-    skill_lessons = [l for l in lessons if l.get("skill") == skill and l.get("status") == "active"]
+    # Get global + skill-specific lessons (skill/status index lookups)
+    global_lessons = store.find(skill="global")
+    skill_lessons = store.find(skill=skill) if skill != "global" else []
 
     total = len(global_lessons) + len(skill_lessons)
     if total == 0:
@@ -0,0 +1,67 @@
+#!/bin/bash
+# Task index lookups (see scripts/task-index.py)
+#
+# Usage (with TASKS_DIR set):
+#   source "$ZENIX_ROOT/skills/core/task/lib/index.sh"
+#   task_index_fresh              # re-index if Tasks/ gained or lost an entry
+#   task_lookup 002 || exit 1     # sets TASK_NAME TASK_ID ... TASK_FILE
+#   task_alloc ids 3              # ids="004 005 006", reserved atomically
+#
+# A lookup reads one by-id/<name> record: exact name first, then the first
+# name starting with the partial id. A record older than its task file is
+# re-indexed before it is returned, so work-path/agent are never stale.
+
+TASK_INDEX_DIR="$ZENIX_ROOT/data/task/index"
+TASK_INDEX="$TASK_INDEX_DIR/index.tsv"
+_TASK_INDEX_PY="${BASH_SOURCE[0]%/*}/../scripts/task-index.py"
+
+task_index_fresh() {
+    if [[ ! -f "$TASK_INDEX" || "$TASKS_DIR" -nt "$TASK_INDEX" ]]; then
+        python3 "$_TASK_INDEX_PY" update >/dev/null || true
+    fi
+}
+
+# _task_read <record-file> - split one index line into TASK_* vars
+_task_read() {
+    local mtime
+    IFS=$'\t' read -r TASK_NAME TASK_ID TASK_SLUG TASK_STATUS TASK_SUBMIT TASK_STAGE \
+        TASK_AGENT TASK_WORK_PATH mtime TASK_FILE TASK_SUMMARY < "$1" || return 1
+    TASK_FILE="$TASKS_DIR/$TASK_FILE"
+    local var
+    for var in TASK_STATUS TASK_SUBMIT TASK_STAGE TASK_AGENT TASK_WORK_PATH; do
+        [[ "${!var}" == "-" ]] && printf -v "$var" '%s' ""
+    done
+    return 0
+}
+
+# task_lookup <id> - exact name, else prefix match
+task_lookup() {
+    local id="$1" record="" f
+    task_index_fresh
+    if [[ -f "$TASK_INDEX_DIR/by-id/$id" ]]; then
+        record="$TASK_INDEX_DIR/by-id/$id"
+    else
+        for f in "$TASK_INDEX_DIR/by-id/$id"*; do
+            [[ -f "$f" ]] && record="$f" && break
+        done
+    fi
+    [[ -n "$record" ]] || return 1
+    _task_read "$record" || return 1
+    if [[ ! -f "$TASK_FILE" ]]; then
+        python3 "$_TASK_INDEX_PY" update >/dev/null || true
+        return 1
+    fi
+    if [[ "$TASK_FILE" -nt "$record" ]]; then
+        python3 "$_TASK_INDEX_PY" update "$TASK_FILE" >/dev/null || true
+        _task_read "$record" || return 1
+    fi
+    return 0
+}
+
+# task_alloc <var> [n] - reserve n consecutive ids (space separated)
+task_alloc() {
+    local __ids
+    task_index_fresh
+    __ids=$(python3 "$_TASK_INDEX_PY" alloc "${2:-1}") || return 1
+    printf -v "$1" '%s' "${__ids//$'\n'/ }"
+}
@@ -1,38 +1,50 @@
 #!/usr/bin/env bash
 # Execute a task by ID
+#
+# Usage:
+#   exec.sh <id>                      Run one task (interactive session)
+#   exec.sh --print <id>              Run headless (agent -p), used by queue
+#   exec.sh --all [--workers N]       Run every task through queue.sh
+#   exec.sh <id> <id>... [--workers N]
 set -euo pipefail
 
-TASK_ID="${1:-}"
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+
+HEADLESS=false
+TASK_IDS=()
+QUEUE_ARGS=()
+while [[ $# -gt 0 ]]; do
+    case "$1" in
+        --print|-p)   HEADLESS=true; shift ;;
+        --all)        QUEUE_ARGS+=("--all"); shift ;;
+        --workers|-j) QUEUE_ARGS+=("--workers" "$2"); shift 2 ;;
+        *)            TASK_IDS+=("$1"); shift ;;
+    esac
+done
+
+# Several tasks (or --all): bounded concurrent run via the queue
+if [[ ${#QUEUE_ARGS[@]} -gt 0 || ${#TASK_IDS[@]} -gt 1 ]]; then
+    exec "$SCRIPT_DIR/queue.sh" run ${QUEUE_ARGS[@]+"${QUEUE_ARGS[@]}"} ${TASK_IDS[@]+"${TASK_IDS[@]}"}
+fi
+
+TASK_ID="${TASK_IDS[0]:-}"
 if [[ -z "$TASK_ID" ]]; then
-    echo "Usage: task exec <task-id>" >&2
+    echo "Usage: task exec <task-id> | --all [--workers N]" >&2
     exit 1
 fi
 
+ZENIX_ROOT="${ZENIX_ROOT:-$HOME/.zenix}"
 VAULT_DIR="${ZENIX_VAULT:-$HOME/.zenix/vault}"
 TASKS_DIR="$VAULT_DIR/Tasks"
 
+source "$ZENIX_ROOT/skills/core/task/lib/index.sh"
+
 # ─────────────────────────────────────────────────────────────
 # Find task file
 # ─────────────────────────────────────────────────────────────
 
-find_task() {
-    local id="$1"
-
-    # Exact match: file
-    [[ -f "$TASKS_DIR/${id}.md" ]] && echo "$TASKS_DIR/${id}.md" && return 0
-
-    # Exact match: folder
-    [[ -f "$TASKS_DIR/${id}/task.md" ]] && echo "$TASKS_DIR/${id}/task.md" && return 0
-
-    # Partial match
-    for f in "$TASKS_DIR"/${id}*.md "$TASKS_DIR"/${id}*/task.md; do
-        [[ -f "$f" ]] && echo "$f" && return 0
-    done
-
-    return 1
-}
-
-TASK_FILE=$(find_task "$TASK_ID") || {
+# Exact id, else prefix, from the task index (lib/index.sh)
+task_lookup "$TASK_ID" || {
     echo "Task not found: $TASK_ID" >&2
     echo "Looking in: $TASKS_DIR" >&2
     exit 1
@@ -41,22 +53,16 @@ TASK_FILE=$(find_task "$TASK_ID") || {
 echo "Task: $TASK_FILE" >&2
 
 # ─────────────────────────────────────────────────────────────
-# Parse frontmatter
+# Task body
 # ─────────────────────────────────────────────────────────────
 
-parse_frontmatter() {
-    local file="$1"
-    local key="$2"
-    grep "^${key}:" "$file" 2>/dev/null | sed "s/${key}:[[:space:]]*//" | head -1
-}
-
 get_body() {
     local file="$1"
     awk '/^---$/{if(++n==2){f=1;next}}f' "$file"
 }
 
-WORK_PATH=$(parse_frontmatter "$TASK_FILE" "work-path")
-AGENT_NAME=$(parse_frontmatter "$TASK_FILE" "agent")
+WORK_PATH="$TASK_WORK_PATH"
+AGENT_NAME="$TASK_AGENT"
 
 # ─────────────────────────────────────────────────────────────
 # Resolve work-path
@@ -94,10 +100,14 @@ fi
 
 cd "$WORK_PATH"
 
+# Headless: the prompt goes through -p so the session exits when done
+PROMPT_ARGS=("$TASK_BODY")
+$HEADLESS && PROMPT_ARGS=("-p" "$TASK_BODY")
+
 if [[ -n "$AGENT_NAME" ]]; then
     echo "Agent: $AGENT_NAME" >&2
-    exec agent -A "$AGENT_NAME" "$TASK_BODY"
+    exec agent -A "$AGENT_NAME" "${PROMPT_ARGS[@]}"
 else
     echo "Agent: (default)" >&2
-    exec agent "$TASK_BODY"
+    exec agent "${PROMPT_ARGS[@]}"
 fi
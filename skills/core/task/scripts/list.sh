@@ -2,28 +2,20 @@
 # List tasks
 set -euo pipefail
 
+ZENIX_ROOT="${ZENIX_ROOT:-$HOME/.zenix}"
 VAULT_DIR="${ZENIX_VAULT:-$HOME/.zenix/vault}"
 TASKS_DIR="$VAULT_DIR/Tasks"
 
+source "$ZENIX_ROOT/skills/core/task/lib/index.sh"
+
 if [[ ! -d "$TASKS_DIR" ]]; then
     echo "No tasks directory: $TASKS_DIR" >&2
     exit 0
 fi
 
-# Find all task files
-for f in "$TASKS_DIR"/*.md "$TASKS_DIR"/*/task.md; do
-    [[ -f "$f" ]] || continue
-
-    # Get task ID from path
-    if [[ "$f" == */task.md ]]; then
-        id=$(basename "$(dirname "$f")")
-    else
-        id=$(basename "$f" .md)
-    fi
-
-    # Get first non-empty line after frontmatter as summary
-    summary=$(awk '/^---$/{if(++n==2){f=1;next}}f && /[^ ]/{print; exit}' "$f" | head -c 60)
-    [[ ${#summary} -eq 60 ]] && summary="${summary}..."
-
-    printf "%-20s %s\n" "$id" "${summary:-(no description)}"
-done
+# One pass over the index (scripts/task-index.py), no task file is opened
+task_index_fresh
+[[ -f "$TASK_INDEX" ]] || exit 0
+while IFS=$'\t' read -r name _ _ _ _ _ _ _ _ _ summary; do
+    printf "%-20s %s\n" "$name" "$summary"
+done < "$TASK_INDEX"
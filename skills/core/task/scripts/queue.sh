@@ -0,0 +1,315 @@
+#!/usr/bin/env bash
+# Task queue - run many tasks with a bounded worker pool
+#
+# Usage:
+#   queue.sh add <id>... | --all       Enqueue tasks (skips queued/done ones)
+#   queue.sh run [--workers N] [--all] [id...]
+#                                      Enqueue, then work the queue until empty
+#   queue.sh status                    Show queue state
+#   queue.sh clear [done|failed|all]   Forget finished entries (default: done)
+#
+# State ($ZENIX_ROOT/data/task/queue/) survives crashes:
+#   pending/<id>   running/<id>   done/<id>   failed/<id>   logs/<id>.log
+# Entries move between states with `mv` (atomic claim). One runner at a
+# time holds runner.lock; a new one puts running/ entries of a dead runner
+# back into pending/ and resumes.
+#
+# Concurrency: --workers N (or $TASK_WORKERS, default 4) bounds the total;
+# models.<alias>.concurrency in agent provider.yaml (else
+# defaults.concurrency, else 1) bounds tasks running per model.
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+ZENIX_ROOT="${ZENIX_ROOT:-$HOME/.zenix}"
+VAULT_DIR="${ZENIX_VAULT:-$HOME/.zenix/vault}"
+TASKS_DIR="$VAULT_DIR/Tasks"
+QUEUE_DIR="$ZENIX_ROOT/data/task/queue"
+PROVIDER_FILE="$ZENIX_ROOT/skills/system/agent/config/provider.yaml"
+
+source "$ZENIX_ROOT/skills/system/zenix/lib/config.sh"
+source "$ZENIX_ROOT/skills/system/zenix/lib/skill-index.sh"
+source "$ZENIX_ROOT/skills/core/task/lib/index.sh"
+
+mkdir -p "$QUEUE_DIR"/{pending,running,done,failed,logs,slots}
+
+# ─────────────────────────────────────────────────────────────
+# Tasks
+# ─────────────────────────────────────────────────────────────
+
+# Same lookup as exec.sh: exact id, then prefix (lib/index.sh)
+resolve_id() {
+    task_lookup "$1" || return 1
+    echo "$TASK_NAME"
+}
+
+all_ids() {
+    local name
+    task_index_fresh
+    [[ -f "$TASK_INDEX" ]] || return 0
+    while IFS=$'\t' read -r name _; do
+        echo "$name"
+    done < "$TASK_INDEX"
+}
+
+frontmatter_value() {
+    grep -m1 "^$2:" "$1" 2>/dev/null | sed "s/^$2:[[:space:]]*//"
+}
+
+# Model alias a task will run on: its agent's model, else the first model
+# of its tier (routing.tiers), else the default
+task_model() {
+    local agent="" model="" agent_file tier=""
+    task_lookup "$1" && agent="$TASK_AGENT"
+    if [[ -n "$agent" ]]; then
+        agent_lookup agent_file "$agent" path
+        if [[ -f "$agent_file" ]]; then
+            model=$(frontmatter_value "$agent_file" model)
+            [[ -z "$model" ]] && tier=$(frontmatter_value "$agent_file" tier)
+        fi
+    fi
+    if [[ -z "$model" && -n "$tier" ]]; then
+        config_read model "routing.tiers.$tier"
+        model="${model%%$'\n'*}"
+    fi
+    [[ -z "$model" ]] && config_read model defaults.model opus
+    echo "$model"
+}
+
+model_cap() {
+    local cap
+    config_read cap "models.$1.concurrency"
+    [[ -z "$cap" ]] && config_read cap defaults.concurrency 1
+    [[ "$cap" =~ ^[1-9][0-9]*$ ]] || cap=1
+    echo "$cap"
+}
+
+# ─────────────────────────────────────────────────────────────
+# Queue
+# ─────────────────────────────────────────────────────────────
+
+enqueue() {
+    local id state added=0
+    for id in "$@"; do
+        for state in pending running done; do
+            [[ -e "$QUEUE_DIR/$state/$id" ]] && continue 2
+        done
+        rm -f "$QUEUE_DIR/failed/$id"
+        date '+%Y-%m-%d %H:%M:%S' > "$QUEUE_DIR/pending/$id"
+        added=$((added + 1))
+    done
+    echo "Queued $added task(s)" >&2
+}
+
+count() {
+    local n=0 f
+    for f in "$QUEUE_DIR/$1"/*; do
+        [[ -e "$f" ]] && n=$((n + 1))
+    done
+    echo "$n"
+}
+
+# acquire_slot <model> - take one of the model's concurrency slots
+acquire_slot() {
+    local model="$1" cap k
+    cap=$(model_cap "$model")
+    for ((k = 0; k < cap; k++)); do
+        mkdir "$QUEUE_DIR/slots/$model.$k" 2>/dev/null && echo "$QUEUE_DIR/slots/$model.$k" && return 0
+    done
+    return 1
+}
+
+run_task() {
+    local id="$1" slot="$2" code=0
+    {
+        echo "=== $id started at $(date '+%Y-%m-%d %H:%M:%S') ==="
+        "$SCRIPT_DIR/exec.sh" --print "$id" 9>&- || code=$?
+        echo "=== $id finished (exit $code) at $(date '+%Y-%m-%d %H:%M:%S') ==="
+    } >> "$QUEUE_DIR/logs/$id.log" 2>&1 < /dev/null
+    rmdir "$slot" 2>/dev/null || true
+
+    if [[ $code -eq 0 ]]; then
+        mv "$QUEUE_DIR/running/$id" "$QUEUE_DIR/done/$id"
+        echo "[done]   $id" >&2
+    else
+        echo "$code" > "$QUEUE_DIR/running/$id"
+        mv "$QUEUE_DIR/running/$id" "$QUEUE_DIR/failed/$id"
+        echo "[failed] $id (exit $code, see logs/$id.log)" >&2
+    fi
+}
+
+worker() {
+    local entry id slot claimed
+    while true; do
+        claimed=""
+        for entry in "$QUEUE_DIR/pending"/*; do
+            [[ -e "$entry" ]] || continue
+            id="${entry##*/}"
+            mv "$entry" "$QUEUE_DIR/running/$id" 2>/dev/null || continue
+            if slot=$(acquire_slot "$(task_model "$id")"); then
+                claimed="$id"
+                break
+            fi
+            # Model at its cap: leave it for a later pass
+            mv "$QUEUE_DIR/running/$id" "$QUEUE_DIR/pending/$id"
+        done
+
+        if [[ -z "$claimed" ]]; then
+            [[ $(count pending) -eq 0 ]] && return 0
+            sleep 1
+            continue
+        fi
+
+        echo "[start]  $claimed" >&2
+        run_task "$claimed" "$slot"
+    done
+}
+
+# lock_try <fd> - non-blocking flock(2) on an open fd, held until every copy
+# of it is closed (python3: there is no flock(1) on macOS)
+lock_try() {
+    python3 -c 'import fcntl, sys; fcntl.flock(int(sys.argv[1]), fcntl.LOCK_EX | fcntl.LOCK_NB)' \
+        "$1" 2>/dev/null
+}
+
+runner_alive() {
+    ! lock_try 8 8>>"$QUEUE_DIR/runner.lock"
+}
+
+# Put back what a crashed runner left behind
+recover() {
+    local entry n=0
+    for entry in "$QUEUE_DIR/running"/*; do
+        [[ -e "$entry" ]] || continue
+        mv "$entry" "$QUEUE_DIR/pending/${entry##*/}" && n=$((n + 1))
+    done
+    rm -rf "$QUEUE_DIR/slots" && mkdir -p "$QUEUE_DIR/slots"
+    [[ $n -gt 0 ]] && echo "Resumed $n interrupted task(s)" >&2
+    return 0
+}
+
+# ─────────────────────────────────────────────────────────────
+# Commands
+# ─────────────────────────────────────────────────────────────
+
+# collect_ids <all> <id>... - resolve ids (or every task) to queue entries
+collect_ids() {
+    local all="$1" id resolved
+    shift
+    if [[ "$all" == true ]]; then
+        all_ids
+        return 0
+    fi
+    for id in "$@"; do
+        if resolved=$(resolve_id "$id"); then
+            echo "$resolved"
+        else
+            echo "Task not found: $id" >&2
+        fi
+    done
+}
+
+cmd_add() {
+    local all=false ids=()
+    [[ "${1:-}" == "--all" ]] && all=true && shift
+    while IFS= read -r id; do
+        [[ -n "$id" ]] && ids+=("$id")
+    done < <(collect_ids "$all" "$@")
+    [[ ${#ids[@]} -gt 0 ]] && enqueue "${ids[@]}"
+    return 0
+}
+
+cmd_run() {
+    local workers="${TASK_WORKERS:-4}" all=false args=()
+    while [[ $# -gt 0 ]]; do
+        case "$1" in
+            --workers|-j) workers="$2"; shift 2 ;;
+            --all)        all=true; shift ;;
+            *)            args+=("$1"); shift ;;
+        esac
+    done
+
+    if $all; then
+        cmd_add --all
+    elif [[ ${#args[@]} -gt 0 ]]; then
+        cmd_add "${args[@]}"
+    fi
+
+    # Lock, work, unlock, then look again: an entry added while this runner
+    # was exiting found the lock held and left it to us
+    while true; do
+        exec 9>>"$QUEUE_DIR/runner.lock"
+        if ! lock_try 9; then
+            exec 9>&-
+            echo "Queue runner already active (PID $(cat "$QUEUE_DIR/runner.pid" 2>/dev/null)); it will pick these up" >&2
+            return 0
+        fi
+        echo $$ > "$QUEUE_DIR/runner.pid"
+        trap 'rm -f "$QUEUE_DIR/runner.pid"' EXIT
+        recover
+        local worked=true
+        run_pending "$workers" || worked=false
+        rm -f "$QUEUE_DIR/runner.pid"
+        exec 9>&-
+        $worked || return 0
+        [[ $(count pending) -eq 0 ]] && break
+    done
+    echo "Done: $(count done) done, $(count failed) failed" >&2
+}
+
+# run_pending <workers> - work the queue until no worker finds an entry
+# (1 if it was empty)
+run_pending() {
+    local workers="$1" pending k
+    pending=$(count pending)
+    [[ $pending -eq 0 ]] && echo "Queue is empty" >&2 && return 1
+    [[ $workers -gt $pending ]] && workers=$pending
+
+    echo "Running $pending task(s) with $workers worker(s)" >&2
+    for ((k = 0; k < workers; k++)); do
+        worker &
+    done
+    wait
+}
+
+cmd_status() {
+    local state entry
+    if runner_alive; then
+        echo "Runner: PID $(cat "$QUEUE_DIR/runner.pid")"
+    else
+        echo "Runner: stopped"
+    fi
+    for state in pending running done failed; do
+        echo "  $state: $(count "$state")"
+    done
+    for entry in "$QUEUE_DIR/running"/* "$QUEUE_DIR/failed"/*; do
+        [[ -e "$entry" ]] || continue
+        echo "    ${entry#$QUEUE_DIR/}"
+    done
+}
+
+cmd_clear() {
+    local which="${1:-done}"
+    case "$which" in
+        done|failed) rm -f "$QUEUE_DIR/$which"/* ;;
+        all)
+            runner_alive && echo "Queue runner active; stop it first" >&2 && return 1
+            rm -f "$QUEUE_DIR"/{pending,running,done,failed}/*
+            ;;
+        *) echo "Usage: task queue clear [done|failed|all]" >&2; return 1 ;;
+    esac
+    echo "Cleared $which" >&2
+}
+
+skill_index_load
+config_load "$PROVIDER_FILE" || true
+
+case "${1:-}" in
+    add)    shift; cmd_add "$@" ;;
+    run)    shift; cmd_run "$@" ;;
+    status) cmd_status ;;
+    clear)  shift; cmd_clear "$@" ;;
+    *)
+        echo "Usage: task queue <add|run|status|clear> [args]" >&2
+        exit 1
+        ;;
+esac
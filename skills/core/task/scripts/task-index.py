@@ -0,0 +1,308 @@
+#!/usr/bin/env python3
+"""
+task-index - Index of vault tasks for task list/exec and note intake.
+
+Lives in $ZENIX_ROOT/data/task/index/:
+
+    index.tsv       one line per task, sorted by name
+    by-id/<name>    the same line, one file per task (lookup without reading
+                    index.tsv: exact name, or a glob for a partial id)
+    next-id         id allocator counter
+
+Fields (tab separated, "-" for empty so bash `read` keeps the columns):
+
+    name  id  slug  status  submit  stage  agent  work-path  mtime  file  summary
+
+name is the task's id as exec/queue use it (Tasks/<name>.md or
+Tasks/<name>/task.md), id its numeric prefix. For folder tasks, stage/status/submit come from the
+newest IVDX document (intention.N.md ... report.md) when task.md has none.
+
+Updates only re-read tasks whose file changed. Kept fresh by the
+task-index watcher; lib/index.sh also re-indexes a task whose file is newer
+than its record, and everything when an entry was added to or removed from
+Tasks/.
+
+Usage:
+    task-index.py build               Re-read every task
+    task-index.py update [<path>...]  Re-index tasks containing <path> (no path: all)
+    task-index.py alloc [n]           Reserve n consecutive ids (default 1), print them
+"""
+
+import fcntl
+import os
+import re
+import sys
+
+sys.dont_write_bytecode = True
+
+ZENIX_ROOT = os.environ.get("ZENIX_ROOT", os.path.expanduser("~/.zenix"))
+VAULT_DIR = os.environ.get("ZENIX_VAULT", os.path.expanduser("~/.zenix/vault"))
+TASKS_DIR = os.path.join(VAULT_DIR, "Tasks")
+INDEX_DIR = os.path.join(ZENIX_ROOT, "data", "task", "index")
+INDEX = os.path.join(INDEX_DIR, "index.tsv")
+BY_ID = os.path.join(INDEX_DIR, "by-id")
+NEXT_ID = os.path.join(INDEX_DIR, "next-id")
+SUMMARY_MAX = 60
+
+FIELDS = ("name", "id", "slug", "status", "submit", "stage", "agent",
+          "work-path", "mtime", "file", "summary")
+STAGES = ("intention", "assessment", "contract", "report")
+NAME_RE = re.compile(r"^(\d+)-?(.*)$")
+DOC_RE = re.compile(r"^(intention|assessment|contract|report)(?:\.(\d+))?\.md$")
+
+
+# ─────────────────────────────────────────────────────────────
+# Task files
+# ─────────────────────────────────────────────────────────────
+
+def read_doc(path: str) -> tuple:
+    """(frontmatter dict of flat key: value, first body line)."""
+    meta, summary = {}, ""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        lines = f.read().split("\n")
+    body = lines
+    if lines and lines[0] == "---":
+        try:
+            end = lines.index("---", 1)
+        except ValueError:
+            end = len(lines)
+        for line in lines[1:end]:
+            key, sep, value = line.partition(":")
+            if sep and key and not key.startswith((" ", "#")):
+                meta.setdefault(key.strip(), value.split(" #")[0].strip().strip("\"'"))
+        body = lines[end + 1:]
+    for line in body:
+        if line.strip():
+            summary = line.strip()
+            break
+    return meta, summary
+
+
+def clean(value: str) -> str:
+    value = " ".join(str(value).split())
+    return value or "-"
+
+
+def latest_doc(folder: str):
+    """Newest IVDX document of a folder task: later stage, then higher round."""
+    best = None
+    for entry in os.listdir(folder):
+        m = DOC_RE.match(entry)
+        if m:
+            rank = (STAGES.index(m.group(1)), int(m.group(2) or 0))
+            if best is None or rank > best[0]:
+                best = (rank, os.path.join(folder, entry))
+    return best[1] if best else None
+
+
+def task_file(name: str):
+    """Path of a task's file (Tasks/<name>.md, else Tasks/<name>/task.md), or None."""
+    path = os.path.join(TASKS_DIR, name)
+    if os.path.isfile(path + ".md"):
+        return path + ".md"
+    if os.path.isfile(os.path.join(path, "task.md")):
+        return os.path.join(path, "task.md")
+    return None
+
+
+def record(name: str, path: str, mtime: float) -> dict:
+    meta, summary = read_doc(path)
+    if len(summary) > SUMMARY_MAX:
+        summary = summary[:SUMMARY_MAX] + "..."
+    m = NAME_RE.match(name)
+    stage = meta.get("stage") or meta.get("type") or ""
+    status, submit = meta.get("status", ""), meta.get("submit", "")
+    if path.endswith("/task.md"):
+        doc = latest_doc(os.path.dirname(path))
+        if doc:
+            doc_meta, _ = read_doc(doc)
+            stage = stage or doc_meta.get("type") or DOC_RE.match(os.path.basename(doc)).group(1)
+            status = status or doc_meta.get("status", "")
+            submit = submit or doc_meta.get("submit", "")
+    return {
+        "name": name,
+        "id": m.group(1) if m else "-",
+        "slug": clean(m.group(2) if m else name),
+        "status": clean(status),
+        "submit": clean(submit),
+        "stage": clean(stage),
+        "agent": clean(meta.get("agent", "")),
+        "work-path": clean(meta.get("work-path", "")),
+        "mtime": f"{mtime:.3f}",
+        "file": os.path.relpath(path, TASKS_DIR),
+        "summary": clean(summary) if summary else "(no description)",
+    }
+
+
+def line(r: dict) -> str:
+    return "\t".join(r[k] for k in FIELDS) + "\n"
+
+
+def task_mtime(path: str) -> float:
+    """Newest mtime of a task: its file, and for folder tasks its documents."""
+    mtime = os.stat(path).st_mtime
+    if path.endswith("/task.md"):
+        doc = latest_doc(os.path.dirname(path))
+        if doc:
+            mtime = max(mtime, os.stat(doc).st_mtime)
+    return mtime
+
+
+# ─────────────────────────────────────────────────────────────
+# Index
+# ─────────────────────────────────────────────────────────────
+
+def load() -> dict:
+    tasks = {}
+    try:
+        with open(INDEX, encoding="utf-8") as f:
+            for raw in f:
+                parts = raw.rstrip("\n").split("\t")
+                if len(parts) == len(FIELDS):
+                    tasks[parts[0]] = dict(zip(FIELDS, parts))
+    except FileNotFoundError:
+        pass
+    return tasks
+
+
+def write_file(path: str, content: str):
+    tmp = f"{path}.{os.getpid()}.tmp"
+    with open(tmp, "w", encoding="utf-8") as f:
+        f.write(content)
+    os.replace(tmp, path)
+
+
+def save(tasks: dict, changed: set):
+    os.makedirs(BY_ID, exist_ok=True)
+    for name in changed:
+        if name in tasks:
+            write_file(os.path.join(BY_ID, name), line(tasks[name]))
+        else:
+            try:
+                os.remove(os.path.join(BY_ID, name))
+            except FileNotFoundError:
+                pass
+    write_file(INDEX, "".join(line(tasks[n]) for n in sorted(tasks)))
+
+
+def index_task(tasks: dict, name: str, changed: set):
+    path = task_file(name)
+    if path is None:
+        if tasks.pop(name, None) is not None:
+            changed.add(name)
+        return
+    mtime = task_mtime(path)
+    old = tasks.get(name)
+    if old and old["mtime"] == f"{mtime:.3f}":
+        return
+    tasks[name] = record(name, path, mtime)
+    changed.add(name)
+
+
+def entries() -> list:
+    try:
+        names = os.listdir(TASKS_DIR)
+    except FileNotFoundError:
+        return []
+    return [n[:-3] if n.endswith(".md") else n for n in names if not n.startswith(".") and
+            (n.endswith(".md") or os.path.isdir(os.path.join(TASKS_DIR, n)))]
+
+
+def rescan(tasks: dict, changed: set):
+    seen = set(entries())
+    for name in [n for n in tasks if n not in seen]:
+        del tasks[name]
+        changed.add(name)
+    for name in sorted(seen):
+        index_task(tasks, name, changed)
+
+
+def names_for(paths: list) -> set:
+    real_tasks = os.path.realpath(TASKS_DIR)
+    names = set()
+    for path in paths:
+        rel = os.path.relpath(os.path.realpath(path), real_tasks).split(os.sep)
+        if rel[0] not in ("..", ".") and not rel[0].startswith("."):
+            names.add(rel[0][:-3] if len(rel) == 1 and rel[0].endswith(".md") else rel[0])
+    return names
+
+
+def update(tasks: dict, changed: set, paths: list):
+    for name in sorted(names_for(paths)):
+        index_task(tasks, name, changed)
+
+
+def locked(fn):
+    """Run fn(tasks, changed) under the index lock, then save the changes."""
+    os.makedirs(INDEX_DIR, exist_ok=True)
+    with open(os.path.join(INDEX_DIR, "lock"), "w") as lock:
+        fcntl.flock(lock, fcntl.LOCK_EX)
+        tasks, changed = load(), set()
+        fn(tasks, changed)
+        if changed or not os.path.exists(INDEX):
+            save(tasks, changed)
+            bump_counter(tasks, changed)
+    return tasks
+
+
+# ─────────────────────────────────────────────────────────────
+# Id allocator
+# ─────────────────────────────────────────────────────────────
+
+def read_counter() -> int:
+    try:
+        with open(NEXT_ID) as f:
+            return int(f.read().strip() or 1)
+    except (OSError, ValueError):
+        return 1
+
+
+def alloc(n: int) -> list:
+    """Reserve n consecutive ids. Reads only the counter, which save() keeps
+    above every indexed id, so allocation does not depend on vault size."""
+    os.makedirs(INDEX_DIR, exist_ok=True)
+    with open(NEXT_ID + ".lock", "w") as lock:
+        fcntl.flock(lock, fcntl.LOCK_EX)
+        start = read_counter()
+        write_file(NEXT_ID, f"{start + n}\n")
+    return [f"{i:03d}" for i in range(start, start + n)]
+
+
+def bump_counter(tasks: dict, changed: set):
+    """Keep next-id above the ids of tasks created without alloc."""
+    top = max((int(tasks[n]["id"]) for n in changed if n in tasks and tasks[n]["id"].isdigit()),
+              default=0)
+    if top == 0:
+        return
+    with open(NEXT_ID + ".lock", "w") as lock:
+        fcntl.flock(lock, fcntl.LOCK_EX)
+        if read_counter() <= top:
+            write_file(NEXT_ID, f"{top + 1}\n")
+
+
+def main():
+    args = sys.argv[1:]
+    cmd = args[0] if args else ""
+    if cmd == "build":
+        def rebuild(tasks, changed):
+            changed.update(tasks)
+            tasks.clear()
+            rescan(tasks, changed)
+        tasks = locked(rebuild)
+        print(f"Indexed {len(tasks)} tasks")
+    elif cmd == "update":
+        if len(args) > 1:
+            locked(lambda t, c: update(t, c, args[1:]))
+        else:
+            locked(rescan)
+    elif cmd == "alloc" and len(args) <= 2:
+        n = int(args[1]) if len(args) > 1 else 1
+        for task_id in alloc(max(n, 1)):
+            print(task_id)
+    else:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,329 @@
+#!/usr/bin/env python3
+"""
+keywords - Incremental keyword list for the memory hint.
+
+Keeps per-document term counts on disk and maintains
+data/memory/custom_keywords.txt from them, so a changed note costs one
+document re-read instead of a corpus rebuild:
+
+    $ZENIX_CACHE/keywords/docs/<hash>.json   one per document: path, mtime,
+                                             size, offset, term counts
+    $ZENIX_CACHE/keywords/totals.json        document frequency and term
+                                             frequency over all documents,
+                                             plus each document's stat
+
+Documents are vault notes ($ZENIX_ROOT/vault/**/*.md, re-read whole when
+they change) and session transcripts (~/.claude/projects/*/*.jsonl, only
+the user prompts; transcripts are append-only, so a grown one is read from
+its last complete line). Updating a document subtracts its old counts from
+the totals and adds the new ones.
+
+Terms are ranked by document frequency, then term frequency; the top
+TOP_N seen in at least MIN_DOCS documents form the list. The hint file is
+rewritten only when that set changes.
+
+Kept fresh by the vault's keywords watchers, which also report deleted
+notes and transcripts (events: Removed). An update also re-stats every
+source once a day (SWEEP_INTERVAL), for changes made while watcherd was
+down.
+
+Usage:
+    keywords.py build                   Rescan every document
+    keywords.py update [<path>...]      Re-index changed documents (no path: all)
+    keywords.py show [n]                Ranked terms with document/term counts
+"""
+
+import fcntl
+import glob
+import hashlib
+import json
+import os
+import re
+import sys
+import time
+
+sys.dont_write_bytecode = True
+
+ZENIX_ROOT = os.environ.get("ZENIX_ROOT", os.path.expanduser("~/.zenix"))
+# Real paths: watcherd reports resolved paths, and both feed the same keys
+VAULT_DIR = os.path.realpath(os.path.join(ZENIX_ROOT, "vault"))
+PROJECTS_DIR = os.path.realpath(os.path.expanduser("~/.claude/projects"))
+OUTPUT = os.path.join(ZENIX_ROOT, "data", "memory", "custom_keywords.txt")
+CACHE_DIR = os.path.join(
+    os.environ.get("ZENIX_CACHE", os.path.expanduser("~/.cache/zenix")), "keywords")
+DOCS_DIR = os.path.join(CACHE_DIR, "docs")
+TOTALS = os.path.join(CACHE_DIR, "totals.json")
+
+TOP_N = 50
+MIN_DOCS = 2
+SWEEP_INTERVAL = 86400
+
+HEADER = """# Custom keywords for memory hint
+# Auto-generated by skills/core/vault/scripts/keywords.py
+# One keyword per line
+#
+"""
+
+WORD_RE = re.compile(r"[a-z][a-z0-9]{2,}")
+CJK_RE = re.compile(r"[一-鿿]{2,}")
+
+STOPWORDS = frozenset("""
+about above after again against all also and any are because been before being
+below between both but can cannot could did does doing down during each few for
+from further had has have having her here hers herself him himself his how into
+its itself just let like may more most must myself nor not now off once only
+other our ours ourselves out over own same she should some such than that the
+their theirs them themselves then there these they this those through too under
+until very was were what when where which while who whom why will with would
+you your yours yourself yourselves get got use using used make made one two
+http https www com
+""".split())
+
+
+# ─────────────────────────────────────────────────────────────
+# Terms
+# ─────────────────────────────────────────────────────────────
+
+def terms(text: str, counts: dict):
+    """Add text's terms to counts: ASCII words, CJK runs as bigrams."""
+    text = text.lower()
+    for word in WORD_RE.findall(text):
+        if word not in STOPWORDS:
+            counts[word] = counts.get(word, 0) + 1
+    for run in CJK_RE.findall(text):
+        for i in range(len(run) - 1):
+            pair = run[i:i + 2]
+            counts[pair] = counts.get(pair, 0) + 1
+
+
+def prompt_text(record: dict) -> str:
+    content = (record.get("message") or {}).get("content")
+    if isinstance(content, str):
+        return content
+    parts = []
+    if isinstance(content, list):
+        for part in content:
+            if isinstance(part, dict) and part.get("type") == "text":
+                parts.append(part.get("text") or "")
+    return " ".join(parts)
+
+
+def read_note(path: str) -> dict:
+    counts = {}
+    with open(path, encoding="utf-8", errors="replace") as f:
+        terms(f.read(), counts)
+    return counts
+
+
+def read_prompts(path: str, start: int, counts: dict) -> int:
+    """Add the user prompts after byte offset start; returns the new offset."""
+    offset = start
+    with open(path, "rb") as f:
+        f.seek(start)
+        for raw in f:
+            if not raw.endswith(b"\n"):
+                break  # line still being written
+            offset += len(raw)
+            if b'"type":"user"' not in raw or b'"tool_result"' in raw:
+                continue
+            try:
+                record = json.loads(raw)
+            except ValueError:
+                continue
+            if record.get("type") == "user":
+                terms(prompt_text(record), counts)
+    return offset
+
+
+# ─────────────────────────────────────────────────────────────
+# State
+# ─────────────────────────────────────────────────────────────
+
+def doc_file(path: str) -> str:
+    return os.path.join(DOCS_DIR, hashlib.sha1(path.encode()).hexdigest()[:16] + ".json")
+
+
+def write_json(path: str, data):
+    tmp = f"{path}.{os.getpid()}.tmp"
+    with open(tmp, "w", encoding="utf-8") as f:
+        json.dump(data, f, ensure_ascii=False, separators=(",", ":"))
+    os.replace(tmp, path)
+
+
+def load_totals() -> dict:
+    try:
+        with open(TOTALS, encoding="utf-8") as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return {"docs": {}, "df": {}, "tf": {}, "swept": 0}
+
+
+def load_doc(path: str) -> dict:
+    try:
+        with open(doc_file(path), encoding="utf-8") as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return {"terms": {}, "offset": 0, "size": 0}
+
+
+def apply(totals: dict, counts: dict, sign: int):
+    df, tf = totals["df"], totals["tf"]
+    for term, n in counts.items():
+        d = df.get(term, 0) + sign
+        if d > 0:
+            df[term] = d
+            tf[term] = tf.get(term, 0) + sign * n
+        else:
+            df.pop(term, None)
+            tf.pop(term, None)
+
+
+def drop(totals: dict, path: str):
+    if totals["docs"].pop(path, None) is None:
+        return
+    apply(totals, load_doc(path)["terms"], -1)
+    try:
+        os.remove(doc_file(path))
+    except FileNotFoundError:
+        pass
+
+
+def index(totals: dict, path: str):
+    """Bring one document's counts (and the totals) up to date."""
+    try:
+        st = os.stat(path)
+    except FileNotFoundError:
+        drop(totals, path)
+        return
+    stat = [round(st.st_mtime, 3), st.st_size]
+    if totals["docs"].get(path) == stat:
+        return
+
+    old = load_doc(path) if path in totals["docs"] else {"terms": {}, "offset": 0, "size": 0}
+    if path.endswith(".jsonl"):
+        if st.st_size >= old["size"] and old["offset"]:
+            counts = dict(old["terms"])
+            offset = read_prompts(path, old["offset"], counts)
+        else:
+            counts = {}
+            offset = read_prompts(path, 0, counts)
+    else:
+        counts, offset = read_note(path), 0
+
+    apply(totals, old["terms"], -1)
+    apply(totals, counts, 1)
+    totals["docs"][path] = stat
+    write_json(doc_file(path), {"path": path, "mtime": stat[0], "size": stat[1],
+                                "offset": offset, "terms": counts})
+
+
+def sources() -> list:
+    found = (glob.glob(os.path.join(VAULT_DIR, "**", "*.md"), recursive=True)
+             + glob.glob(os.path.join(PROJECTS_DIR, "*", "*.jsonl")))
+    return [os.path.realpath(p) for p in found]
+
+
+def sweep(totals: dict):
+    """Re-stat every source: index changed documents, drop vanished ones."""
+    seen = set(sources())
+    for path in [p for p in totals["docs"] if p not in seen]:
+        drop(totals, path)
+    for path in sorted(seen):
+        index(totals, path)
+    totals["swept"] = time.time()
+
+
+def wanted(path: str) -> bool:
+    """Paths a watcher may hand us that are documents of ours."""
+    if path.endswith(".md"):
+        return "/.obsidian/" not in path
+    return path.endswith(".jsonl")
+
+
+# ─────────────────────────────────────────────────────────────
+# Ranking and the hint file
+# ─────────────────────────────────────────────────────────────
+
+def ranked(totals: dict) -> list:
+    df, tf = totals["df"], totals["tf"]
+    return sorted((t for t, n in df.items() if n >= MIN_DOCS), key=lambda t: (-df[t], -tf[t], t))
+
+
+def current_keywords() -> set:
+    try:
+        with open(OUTPUT, encoding="utf-8") as f:
+            return {line.strip() for line in f if line.strip() and not line.startswith("#")}
+    except FileNotFoundError:
+        return set()
+
+
+def publish(totals: dict):
+    """Rewrite the hint file if the top-N set changed."""
+    top = set(ranked(totals)[:TOP_N])
+    old = current_keywords()
+    if top == old:
+        return
+    os.makedirs(os.path.dirname(OUTPUT), exist_ok=True)
+    tmp = f"{OUTPUT}.{os.getpid()}.tmp"
+    with open(tmp, "w", encoding="utf-8") as f:
+        f.write(HEADER)
+        for term in sorted(top):
+            f.write(term + "\n")
+    os.replace(tmp, OUTPUT)
+    added, removed = sorted(top - old), sorted(old - top)
+    print(f"custom_keywords.txt: +{len(added)} -{len(removed)}"
+          + (f" (+{' +'.join(added[:5])})" if added else "")
+          + (f" (-{' -'.join(removed[:5])})" if removed else ""))
+
+
+def locked(fn):
+    """Run fn(totals) under the state lock, save, and publish the result."""
+    os.makedirs(DOCS_DIR, exist_ok=True)
+    with open(TOTALS + ".lock", "w") as lock:
+        fcntl.flock(lock, fcntl.LOCK_EX)
+        totals = load_totals()
+        fn(totals)
+        write_json(TOTALS, totals)
+        publish(totals)
+    return totals
+
+
+def update(totals: dict, paths: list):
+    for path in paths:
+        if wanted(path):
+            index(totals, os.path.realpath(path))
+    if time.time() - totals.get("swept", 0) > SWEEP_INTERVAL:
+        sweep(totals)
+
+
+def rebuild(totals: dict):
+    for path in glob.glob(os.path.join(DOCS_DIR, "*.json")):
+        os.remove(path)
+    totals.clear()
+    totals.update(docs={}, df={}, tf={}, swept=0)
+    sweep(totals)
+
+
+def main():
+    args = sys.argv[1:]
+    cmd = args[0] if args else ""
+    if cmd == "build":
+        totals = locked(rebuild)
+        print(f"Indexed {len(totals['docs'])} documents, {len(totals['df'])} terms")
+    elif cmd == "update":
+        if len(args) > 1:
+            locked(lambda t: update(t, args[1:]))
+        else:
+            locked(sweep)
+    elif cmd == "show" and len(args) <= 2:
+        totals = load_totals()
+        n = int(args[1]) if len(args) > 1 else TOP_N
+        for i, term in enumerate(ranked(totals)[:n], 1):
+            print(f"{i:>4}  {term:<24} {totals['df'][term]:>6} docs {totals['tf'][term]:>8}")
+    else:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,79 +1,97 @@
 #!/bin/bash
-# Process a new raw note into the IVDX system
-# Usage: ./new-note.sh <path-to-note.md>
+# Process new raw notes into the IVDX system
+# Usage: ./new-note.sh <path-to-note.md>...
 #
-# Note may contain ONE or MULTIPLE ideas. AI will split if needed.
+# The vault watcher passes every note of a debounced burst at once (batch
+# rule), so N notes cost one agent call. Each note may contain ONE or
+# MULTIPLE ideas. AI will split if needed.
 
 set -e
 
-SKILL_DIR=~/.zenix/skills/vault
+ZENIX_ROOT="${ZENIX_ROOT:-$HOME/.zenix}"
+SKILL_DIR="$ZENIX_ROOT/skills/core/vault"
 VAULT_DIR="$(cd ~/.zenix/vault && pwd -P)"
+TASKS_DIR="$VAULT_DIR/Tasks"
 
-# Get absolute path for note (before cd'ing later)
-NOTE_PATH="$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
-
-if [[ -z "$1" ]]; then
-    echo "Usage: $0 <path-to-note.md>"
+if [[ $# -eq 0 ]]; then
+    echo "Usage: $0 <path-to-note.md>..."
     exit 1
 fi
 
-if [[ ! -f "$NOTE_PATH" ]]; then
-    echo "Error: File not found: $NOTE_PATH"
-    exit 1
-fi
-
-# Title = filename without extension
-TITLE=$(basename "$NOTE_PATH" .md)
-
-# Skip untitled/empty title files
-if [[ "$TITLE" == "Untitled" || "$TITLE" == "untitled" || -z "$TITLE" ]]; then
-    echo "Skipping: no real title yet"
-    exit 0
-fi
-
-# Get next task number (AI will use this as starting point)
-LAST_NUM=$(ls -d "$VAULT_DIR/active/"*/ 2>/dev/null | grep -oE '[0-9]+' | sort -n | tail -1 || echo "0")
-NEXT_NUM=$(printf "%03d" $((${LAST_NUM:-0} + 1)))
-
-echo "Title:    $TITLE"
-echo "Next ID:  $NEXT_NUM"
-
-# Get content (may be empty)
-NOTE_CONTENT=$(cat "$NOTE_PATH" 2>/dev/null || echo "")
-
-# Build the idea text: title first, then content if any
-if [[ -n "$NOTE_CONTENT" ]]; then
-    IDEA="$TITLE
+# Absolute paths of the notes worth processing (before cd'ing later)
+NOTES=()
+for arg in "$@"; do
+    note="$(cd "$(dirname "$arg")" && pwd)/$(basename "$arg")"
+    title=$(basename "$note" .md)
+    if [[ ! -f "$note" ]]; then
+        echo "Skipping: file not found: $note"
+    elif [[ "$title" == "Untitled" || "$title" == "untitled" || -z "$title" ]]; then
+        echo "Skipping: no real title yet: $note"
+    else
+        NOTES+=("$note")
+    fi
+done
+[[ ${#NOTES[@]} -gt 0 ]] || exit 0
+
+# One task number per note, reserved atomically from the task index, so
+# concurrent intakes never pick the same numbers
+source "$ZENIX_ROOT/skills/core/task/lib/index.sh"
+task_alloc IDS "${#NOTES[@]}"
+read -ra IDS <<< "$IDS"
+
+# Build the notes section: reserved number, title, then content if any
+NOTES_TEXT=""
+for i in "${!NOTES[@]}"; do
+    title=$(basename "${NOTES[$i]}" .md)
+    echo "Note:     $title → ${IDS[$i]}"
+    NOTES_TEXT+="
+Raw note $((i + 1)) (task number ${IDS[$i]}):
+---
+$title
 
-$NOTE_CONTENT"
-else
-    IDEA="$TITLE"
-fi
+$(cat "${NOTES[$i]}" 2>/dev/null || true)
+---
+"
+done
 
 # Load the intention prompt
 PROMPT=$(cat "$SKILL_DIR/prompts/intention.md")
 
-# Call claude in headless mode with the prompt (from vault dir)
-echo "Calling Claude..."
+# Intentions that exist before the run; any other one afterwards is new,
+# including tasks the agent numbers itself for multi-idea notes
+BEFORE=$'\n'
+for doc in "$TASKS_DIR"/*/intention.1.md; do
+    [[ -f "$doc" ]] && BEFORE+="$doc"$'\n'
+done
+
+# Headless agent run (from vault dir); dispatch routes the standard tier
+# and fails over to another model on a rate limit
+echo "Calling agent for ${#NOTES[@]} note(s)..."
 cd "$VAULT_DIR"
-cc -p --append-system-prompt "$PROMPT" \
-    "New note detected. Process into IVDX task(s).
+"$ZENIX_ROOT/bin/agent" --tier standard --append-system-prompt "$PROMPT" -p \
+    "New notes detected. Process each into IVDX task(s).
 
 Vault directory: $VAULT_DIR
-Next task number: $NEXT_NUM
-
-Raw note:
----
-$IDEA
----
-
-Analyze the note:
-1. If MULTIPLE distinct ideas → create multiple task folders starting from $NEXT_NUM
-2. If SINGLE idea → create one task folder $NEXT_NUM-slug
+Reserved task numbers: ${IDS[*]} (one per note, in order)
+$NOTES_TEXT
+Analyze each note:
+1. If SINGLE idea → create one task folder <its number>-slug
+2. If MULTIPLE distinct ideas → the first task uses the note's number; get
+   a number for each further task from:
+   $ZENIX_ROOT/skills/core/task/scripts/task-index.py alloc
 
 For each task, create task.md and intention.1.md.
 Update vault/index.md with all new tasks."
 
-# Delete original note after processing
-rm "$NOTE_PATH"
-echo "Processed and removed: $NOTE_PATH"
+# Delete original notes after processing
+for note in "${NOTES[@]}"; do
+    rm "$note"
+    echo "Processed and removed: $note"
+done
+
+# Hand the new tasks to the stage engine: a confirmed intention without
+# open questions goes on to assessment without waiting for a human submit
+for doc in "$TASKS_DIR"/*/intention.1.md; do
+    [[ -f "$doc" && "$BEFORE" != *$'\n'"$doc"$'\n'* ]] || continue
+    python3 "$SKILL_DIR/scripts/stage-engine.py" submit "$doc" --auto
+done
@@ -0,0 +1,548 @@
+#!/usr/bin/env python3
+"""
+stage-engine - IVDX stage daemon for vault tasks.
+
+Holds the intention → assessment → contract → execution state machine of
+every task in memory and runs the stages as headless sessions:
+
+- Submissions land in a spool dir and wake the daemon with SIGUSR1
+  (submit.sh, new-note.sh); the first submit starts the daemon
+- Independent tasks advance concurrently (`workers`), one stage at a time
+  per task; a submission for a busy task waits for its current stage
+- When a stage writes a document that passes its gate (config/stages.yaml),
+  the next stage starts at once in the same session (--resume), instead of
+  waiting for a human submit, a watcher debounce and a cold launch
+- Every transition is appended to stages.jsonl. `run --resume` restarts
+  stages that were running when the engine stopped, in their session; a
+  stage whose process outlived a killed engine is waited for instead, so
+  it never runs twice at once
+
+State ($ZENIX_ROOT/data/vault/stages/):
+    spool/<ts>.json     Pending submissions {"doc", "auto"}
+    stages.jsonl        {"ts","task","event","stage","doc","session",...}
+    engine.pid          Daemon pid (flock'd while it runs)
+    engine.log          Daemon output
+    logs/<task>.log     Session output per task
+
+Usage:
+    stage-engine.py submit <doc> [--auto]   Queue a document (--auto: only if its gate passes)
+    stage-engine.py run [--resume]          Run the daemon in the foreground
+    stage-engine.py status                  Daemon state and each task's last transition
+    stage-engine.py stop                    Stop the daemon (running stages resume later)
+"""
+
+import collections
+import fcntl
+import json
+import os
+import select
+import signal
+import subprocess
+import sys
+import time
+import uuid
+
+sys.dont_write_bytecode = True
+
+ZENIX_ROOT = os.environ.get("ZENIX_ROOT", os.path.expanduser("~/.zenix"))
+SKILL_DIR = os.path.join(ZENIX_ROOT, "skills", "core", "vault")
+VAULT_DIR = os.environ.get("ZENIX_VAULT", os.path.join(ZENIX_ROOT, "vault"))
+CONFIG = os.path.join(SKILL_DIR, "config", "stages.yaml")
+STATE_DIR = os.path.join(ZENIX_ROOT, "data", "vault", "stages")
+SPOOL_DIR = os.path.join(STATE_DIR, "spool")
+LOG_DIR = os.path.join(STATE_DIR, "logs")
+STAGES_LOG = os.path.join(STATE_DIR, "stages.jsonl")
+PID_FILE = os.path.join(STATE_DIR, "engine.pid")
+ENGINE_LOG = os.path.join(STATE_DIR, "engine.log")
+
+sys.path.insert(0, os.path.join(ZENIX_ROOT, "skills", "system", "zenix", "lib"))
+import config_cache  # noqa: E402
+
+# Document type → (next stage, prompt); same table submit.sh used
+TRANSITIONS = {
+    "intention": ("assessment", "assessment.md"),
+    "eval": ("assessment", "assessment.md"),
+    "assessment": ("contract", "contract.md"),
+    "contract": ("execution", "execution.md"),
+}
+DOC_ORDER = ("intention", "assessment", "contract", "report")
+ORPHAN_POLL = 5.0  # seconds between checks on a previous engine's stage
+
+
+def now_hms() -> str:
+    return time.strftime("%H:%M:%S")
+
+
+def load_config() -> dict:
+    try:
+        cfg = config_cache.load(CONFIG)
+    except (OSError, ValueError):
+        cfg = {}
+    command = cfg.get("command") or ["claude"]
+    if isinstance(command, str):
+        command = command.split()
+    return {
+        "command": [str(c) for c in command],
+        "workers": max(int(cfg.get("workers") or 3), 1),
+        "idle": float(cfg.get("idle") or 600),
+        "auto": cfg.get("auto", True) not in (False, "false", "no", "0"),
+        "gates": cfg.get("gates") or {},
+    }
+
+
+# ─────────────────────────────────────────────────────────────
+# Documents
+# ─────────────────────────────────────────────────────────────
+
+def read_doc(path: str) -> tuple:
+    """(flat frontmatter dict, body text)."""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+    lines = text.split("\n")
+    if not lines or lines[0] != "---":
+        return {}, text
+    try:
+        end = lines.index("---", 1)
+    except ValueError:
+        return {}, text
+    meta = {}
+    for line in lines[1:end]:
+        key, sep, value = line.partition(":")
+        if sep and key and not key.startswith((" ", "#")):
+            meta.setdefault(key.strip(), value.split(" #")[0].strip().strip("\"'"))
+    return meta, "\n".join(lines[end + 1:])
+
+
+def open_questions(body: str) -> bool:
+    """Does the "## Key Questions" section hold anything but its placeholder?"""
+    section, inside = [], False
+    for line in body.split("\n"):
+        if line.startswith("## "):
+            if inside:
+                break
+            inside = line.strip() == "## Key Questions"
+            continue
+        if inside and line.strip() and not line.strip().startswith("("):
+            section.append(line)
+    return bool(section)
+
+
+def gate_passes(gate: dict, meta: dict, body: str) -> bool:
+    if not gate:
+        return False
+    for key, want in gate.items():
+        if key == "questions":
+            if str(want) == "none" and open_questions(body):
+                return False
+        elif str(meta.get(key, "")).lower() != str(want).lower():
+            return False
+    return True
+
+
+def latest_doc(task_dir: str):
+    """Newest stage document of a task: later stage, then higher round."""
+    best = None
+    try:
+        entries = os.listdir(task_dir)
+    except FileNotFoundError:
+        return None
+    for entry in entries:
+        stem = entry[:-3] if entry.endswith(".md") else ""
+        kind, _, rnd = stem.partition(".")
+        if kind in DOC_ORDER and (not rnd or rnd.isdigit()):
+            rank = (DOC_ORDER.index(kind), int(rnd or 0))
+            if best is None or rank > best[0]:
+                best = (rank, os.path.join(task_dir, entry))
+    return best[1] if best else None
+
+
+# ─────────────────────────────────────────────────────────────
+# Transition log
+# ─────────────────────────────────────────────────────────────
+
+def record(event: str, task: str, **fields):
+    entry = {"ts": round(time.time(), 3), "task": task, "event": event}
+    entry.update(fields)
+    with open(STAGES_LOG, "a", encoding="utf-8") as f:
+        f.write(json.dumps(entry, ensure_ascii=False) + "\n")
+
+
+def replay() -> dict:
+    """{task: last entry}, with the task's session carried forward."""
+    last = {}
+    try:
+        with open(STAGES_LOG, encoding="utf-8") as f:
+            for line in f:
+                try:
+                    entry = json.loads(line)
+                except ValueError:
+                    continue
+                prev = last.get(entry["task"], {})
+                if not entry.get("session") and prev.get("session"):
+                    entry["session"] = prev["session"]
+                last[entry["task"]] = entry
+    except FileNotFoundError:
+        pass
+    return last
+
+
+def process_alive(pid: int) -> bool:
+    try:
+        os.kill(pid, 0)
+    except ProcessLookupError:
+        return False
+    except PermissionError:
+        pass
+    return True
+
+
+# ─────────────────────────────────────────────────────────────
+# Engine
+# ─────────────────────────────────────────────────────────────
+
+class Task:
+    def __init__(self, task_dir: str):
+        self.dir = task_dir
+        self.name = os.path.basename(task_dir)
+        self.session = ""
+        self.started = False     # session exists (resume rather than create)
+        self.queue = collections.deque()   # (doc, auto, resumed)
+        self.proc = None
+        self.orphan = 0          # pid of a stage a killed engine left running
+        self.stage = ""
+        self.doc = ""
+        self.since = 0.0
+
+
+class Engine:
+    def __init__(self, resume: bool):
+        self.cfg = load_config()
+        self.tasks = {}
+        self.ready = collections.deque()   # tasks with queued work, FIFO
+        self.stopping = False
+        self.wake_r, self.wake_w = os.pipe()
+        for fd in (self.wake_r, self.wake_w):
+            os.set_blocking(fd, False)
+        for entry in replay().values():
+            if not entry.get("doc"):
+                continue
+            task = self.task(os.path.dirname(entry["doc"]))
+            task.session = entry.get("session", "")
+            task.started = bool(task.session)
+            pid = entry.get("pid", 0) if entry["event"] == "start" else 0
+            if resume and pid and process_alive(pid):
+                task.orphan, task.stage, task.doc = pid, entry.get("stage", ""), entry["doc"]
+                self.log(f"[WAIT] {task.name}: {task.stage} still running from a previous engine (pid {pid})")
+            elif resume and entry["event"] in ("start", "interrupted"):
+                self.log(f"[RESUME] {task.name}: {entry.get('stage')} ({entry['doc']})")
+                self.enqueue(task, entry["doc"], auto=False, resumed=True)
+
+    def log(self, msg: str):
+        print(f"{now_hms()} {msg}", flush=True)
+
+    def task(self, task_dir: str) -> Task:
+        task_dir = os.path.normpath(task_dir)
+        t = self.tasks.get(task_dir)
+        if t is None:
+            t = self.tasks[task_dir] = Task(task_dir)
+            # A session the intention stage already started (task.md session_id)
+            meta, _ = read_doc(os.path.join(task_dir, "task.md")) if os.path.isfile(
+                os.path.join(task_dir, "task.md")) else ({}, "")
+            if meta.get("session_id"):
+                t.session, t.started = meta["session_id"], True
+        return t
+
+    def enqueue(self, task: Task, doc: str, auto: bool, resumed: bool = False):
+        if any(q[0] == doc for q in task.queue):
+            return
+        task.queue.append((doc, auto, resumed))
+        if task not in self.ready:
+            self.ready.append(task)
+
+    # ── Spool ──
+
+    def drain_spool(self):
+        for name in sorted(os.listdir(SPOOL_DIR)):
+            path = os.path.join(SPOOL_DIR, name)
+            if not name.endswith(".json"):
+                continue
+            try:
+                with open(path) as f:
+                    job = json.load(f)
+            except (OSError, ValueError):
+                job = None
+            os.remove(path)
+            if job and job.get("doc"):
+                doc = os.path.abspath(job["doc"])
+                self.enqueue(self.task(os.path.dirname(doc)), doc, bool(job.get("auto")))
+
+    # ── Stages ──
+
+    def plan(self, task: Task, doc: str, auto: bool):
+        """(stage, prompt) to run for a document, or None with the reason logged."""
+        if not os.path.isfile(doc):
+            self.log(f"[SKIP] {task.name}: document gone: {doc}")
+            return None
+        meta, body = read_doc(doc)
+        kind = meta.get("type", "")
+        if kind == "report":
+            record("review", task.name, doc=doc)
+            self.log(f"[DONE] {task.name}: report ready for human review")
+            return None
+        if kind not in TRANSITIONS:
+            record("error", task.name, doc=doc, error=f"unknown type: {kind}")
+            self.log(f"[ERR] {task.name}: unknown document type: {kind or '(none)'}")
+            return None
+        if kind == "contract" and meta.get("status") != "signed":
+            record("wait", task.name, doc=doc, reason="contract not signed")
+            self.log(f"[WAIT] {task.name}: contract not signed yet")
+            return None
+        if auto and not (self.cfg["auto"] and gate_passes(self.cfg["gates"].get(kind), meta, body)):
+            record("gate", task.name, doc=doc, stage=kind)
+            self.log(f"[GATE] {task.name}: {kind} waits for human submit")
+            return None
+        return TRANSITIONS[kind]
+
+    def start_next(self):
+        running = sum(1 for t in self.tasks.values() if t.proc or t.orphan)
+        for _ in range(len(self.ready)):
+            if running >= self.cfg["workers"]:
+                return
+            task = self.ready.popleft()
+            if task.proc or task.orphan:
+                self.ready.append(task)  # busy: keep its place
+                continue
+            while task.queue and not task.proc:
+                doc, auto, resumed = task.queue.popleft()
+                planned = self.plan(task, doc, auto)
+                if planned:
+                    self.spawn(task, doc, *planned, auto=auto, resumed=resumed)
+            if task.proc:
+                running += 1
+            if task.queue:
+                self.ready.append(task)
+
+    def spawn(self, task: Task, doc: str, stage: str, prompt_file: str, auto: bool, resumed: bool):
+        with open(os.path.join(SKILL_DIR, "prompts", prompt_file), encoding="utf-8") as f:
+            prompt = f.read()
+        verb = "approved (gate passed)" if auto else "submitted"
+        message = (f"Document {verb} for task: {task.name}\n\n"
+                   f"Submitted document: {doc}\n"
+                   f"Next stage: {stage}\n\n"
+                   f"Read the submitted document and any human feedback, then proceed to {stage} stage.")
+        if resumed:
+            message = f"(Resumed after an interruption.) {message}"
+        if not task.session:
+            task.session = str(uuid.uuid4())
+        session = ["--resume", task.session] if task.started else ["--session-id", task.session]
+        argv = self.cfg["command"] + ["-p", "--append-system-prompt", prompt] + session + [message]
+
+        out = open(os.path.join(LOG_DIR, task.name + ".log"), "a")
+        out.write(f"\n=== {stage} from {os.path.basename(doc)} at {time.strftime('%Y-%m-%d %H:%M:%S')} ===\n")
+        out.flush()
+        try:
+            task.proc = subprocess.Popen(argv, cwd=VAULT_DIR, stdin=subprocess.DEVNULL,
+                                         stdout=out, stderr=subprocess.STDOUT)
+        except OSError as e:
+            record("failed", task.name, stage=stage, doc=doc, error=str(e))
+            self.log(f"[ERR] {task.name}: {stage}: {e}")
+            return
+        finally:
+            out.close()
+        task.started, task.stage, task.doc, task.since = True, stage, doc, time.time()
+        record("start", task.name, stage=stage, doc=doc, session=task.session,
+               auto=auto, pid=task.proc.pid)
+        self.log(f"[EXEC] {task.name}: {stage}{' (auto)' if auto else ''} session {task.session[:8]}")
+
+    def reap(self):
+        for task in self.tasks.values():
+            if task.orphan and not process_alive(task.orphan):
+                self.reap_orphan(task)
+            if not task.proc:
+                continue
+            code = task.proc.poll()
+            if code is None:
+                continue
+            secs = round(time.time() - task.since, 1)
+            task.proc = None
+            if code != 0:
+                record("failed", task.name, stage=task.stage, doc=task.doc, code=code, secs=secs)
+                self.log(f"[FAIL] {task.name}: {task.stage} exited {code} after {secs}s")
+                continue
+            record("done", task.name, stage=task.stage, doc=task.doc, secs=secs)
+            self.log(f"[OK] {task.name}: {task.stage} in {secs}s")
+            # Pipeline: the document this stage wrote may advance on its own
+            produced = latest_doc(task.dir)
+            if produced and produced != task.doc:
+                self.enqueue(task, produced, auto=True)
+            elif task.queue and task not in self.ready:
+                self.ready.append(task)
+
+    def reap_orphan(self, task: Task):
+        """A previous engine's stage is gone: advance on its document, or rerun it."""
+        task.orphan = 0
+        produced = latest_doc(task.dir)
+        if produced and produced != task.doc:
+            self.log(f"[OK] {task.name}: {task.stage} from the previous engine finished")
+            self.enqueue(task, produced, auto=True)
+        else:
+            self.log(f"[RESUME] {task.name}: {task.stage} from the previous engine left no document")
+            self.enqueue(task, task.doc, auto=False, resumed=True)
+
+    # ── Loop ──
+
+    def wake(self, *_):
+        try:
+            os.write(self.wake_w, b"x")
+        except OSError:
+            pass
+
+    def stop(self, *_):
+        self.stopping = True
+        self.wake()
+
+    def busy(self) -> bool:
+        return any(t.proc or t.orphan for t in self.tasks.values())
+
+    def run(self):
+        signal.signal(signal.SIGUSR1, self.wake)
+        signal.signal(signal.SIGCHLD, self.wake)
+        signal.signal(signal.SIGTERM, self.stop)
+        signal.signal(signal.SIGINT, self.stop)
+        self.log(f"[START] stage engine pid {os.getpid()}, {self.cfg['workers']} workers")
+        idle_since = time.time()
+        while not self.stopping:
+            self.drain_spool()
+            self.reap()
+            self.start_next()
+            if self.busy() or self.ready:
+                idle_since = time.time()
+                # Not our children: no SIGCHLD when they exit
+                timeout = ORPHAN_POLL if any(t.orphan for t in self.tasks.values()) else None
+            else:
+                timeout = self.cfg["idle"] - (time.time() - idle_since)
+                if timeout <= 0:
+                    self.log("[IDLE] nothing to do, exiting")
+                    break
+            try:
+                select.select([self.wake_r], [], [], timeout)
+            except InterruptedError:
+                pass
+            try:
+                while os.read(self.wake_r, 512):
+                    pass
+            except OSError:
+                pass
+
+        for task in self.tasks.values():
+            if task.proc and task.proc.poll() is None:
+                task.proc.terminate()
+                record("interrupted", task.name, stage=task.stage, doc=task.doc, session=task.session)
+                self.log(f"[STOP] {task.name}: {task.stage} interrupted (resume with run --resume)")
+        self.log("[STOP] stage engine stopped")
+
+
+# ─────────────────────────────────────────────────────────────
+# Commands
+# ─────────────────────────────────────────────────────────────
+
+def pid_alive():
+    try:
+        with open(PID_FILE) as f:
+            pid = int(f.read().strip())
+        os.kill(pid, 0)
+        return pid
+    except (OSError, ValueError):
+        return None
+
+
+def spooled() -> list:
+    return [n for n in os.listdir(SPOOL_DIR) if n.endswith(".json")]
+
+
+def cmd_run(resume: bool):
+    engine = None
+    while True:
+        lock = open(PID_FILE + ".lock", "w")
+        try:
+            fcntl.flock(lock, fcntl.LOCK_EX | fcntl.LOCK_NB)
+        except OSError:
+            return  # another engine owns the spool
+        with open(PID_FILE, "w") as f:
+            f.write(f"{os.getpid()}\n")
+        try:
+            engine = engine or Engine(resume)
+            engine.run()
+        finally:
+            try:
+                os.remove(PID_FILE)
+            except FileNotFoundError:
+                pass
+            lock.close()
+        # Idle exit: a submit that signalled us while we were exiting left
+        # its job in the spool, so look once more with the lock released
+        if engine.stopping or not spooled():
+            return
+
+
+def cmd_submit(doc: str, auto: bool):
+    if not os.path.isfile(doc):
+        print(f"Error: File not found: {doc}", file=sys.stderr)
+        sys.exit(1)
+    job = {"doc": os.path.abspath(doc), "auto": auto, "ts": time.time()}
+    path = os.path.join(SPOOL_DIR, f"{time.time():.6f}-{os.getpid()}.json")
+    with open(path + ".tmp", "w") as f:
+        json.dump(job, f)
+    os.replace(path + ".tmp", path)
+
+    pid = pid_alive()
+    if pid:
+        os.kill(pid, signal.SIGUSR1)
+    else:
+        with open(ENGINE_LOG, "a") as out:
+            subprocess.Popen([sys.executable, os.path.abspath(__file__), "run", "--resume"],
+                             stdin=subprocess.DEVNULL, stdout=out, stderr=subprocess.STDOUT,
+                             start_new_session=True)
+    print(f"Queued {os.path.basename(os.path.dirname(job['doc']))}/{os.path.basename(doc)}"
+          f"{' (auto)' if auto else ''}")
+
+
+def cmd_status():
+    pid = pid_alive()
+    print(f"engine: {'running (pid ' + str(pid) + ')' if pid else 'stopped'}")
+    pending = spooled()
+    if pending:
+        print(f"spool: {len(pending)} pending")
+    for name, entry in sorted(replay().items()):
+        when = time.strftime("%m-%d %H:%M", time.localtime(entry["ts"]))
+        stage = entry.get("stage") or ""
+        doc = os.path.basename(entry.get("doc", ""))
+        print(f"{name:<28} {entry['event']:<12} {stage:<11} {doc:<18} {when}")
+
+
+def main():
+    for d in (SPOOL_DIR, LOG_DIR):
+        os.makedirs(d, exist_ok=True)
+    args = [a for a in sys.argv[1:] if not a.startswith("--")]
+    flags = {a for a in sys.argv[1:] if a.startswith("--")}
+    cmd = args[0] if args else ""
+    if cmd == "submit" and len(args) == 2:
+        cmd_submit(args[1], "--auto" in flags)
+    elif cmd == "run" and len(args) == 1:
+        cmd_run("--resume" in flags)
+    elif cmd == "status":
+        cmd_status()
+    elif cmd == "stop":
+        pid = pid_alive()
+        if pid:
+            os.kill(pid, signal.SIGTERM)
+            print(f"Stopped stage engine (pid {pid})")
+        else:
+            print("Stage engine not running")
+    else:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,83 @@
+#!/bin/bash
+# Warm agent pool - prepared sessions leased by `agent -A <name>`
+#
+# A slot is what dispatch.sh would otherwise compute on every launch:
+# framework, assembled system prompt (agent body + skills), session id and
+# a created workspace dir. The model is routed at lease time (route_lease),
+# from the slot's routing inputs and the real prompt. `ZENIX_PREPARE=<slot>` makes
+# dispatch.sh write it to <slot>/env.sh instead of launching.
+#
+# Layout ($ZENIX_ROOT/data/agent/pool/<agent>/):
+#   ready/<slot>/env.sh      Exported ZENIX_* vars, ROUTE_* inputs, FRAMEWORK_SCRIPT
+#   ready/<slot>/repo_root   Repo the workspace was prepared for
+#   ready/<slot>/workspace   Workspace dir (removed with a discarded slot,
+#                            or returned if it came from the workspace pool)
+#   leased/<slot>/           Claimed by `mv` (atomic), removed on launch
+#
+# Usage:
+#   source "$AGENT_DIR/lib/pool.sh"
+#   slot=$(pool_lease executor "$AGENT_FILE") && source "$slot/env.sh"
+
+POOL_DIR="$ZENIX_ROOT/data/agent/pool"
+_POOL_AGENT_DIR="$(cd "${BASH_SOURCE[0]%/*}/.." && pwd)"
+
+# pool_stale <slot> <agent-file> - prepared before its inputs last changed?
+pool_stale() {
+    local slot="$1" agent_file="$2"
+    local env="$slot/env.sh"
+    [[ -f "$env" ]] || return 0
+    [[ "$agent_file" -nt "$env" ]] && return 0
+    [[ "$_POOL_AGENT_DIR/config/provider.yaml" -nt "$env" ]] && return 0
+    # Skills section of the prompt comes from the skill index
+    [[ "${SKILL_INDEX:-}" -nt "$env" ]] && return 0
+    return 1
+}
+
+# pool_discard <slot> - drop slot and its untouched workspace dir
+pool_discard() {
+    local slot="$1"
+    local workspace=""
+    [[ -f "$slot/workspace" ]] && workspace=$(cat "$slot/workspace")
+    if [[ -n "$workspace" && -d "$workspace/.jj" ]]; then
+        # Claimed from the workspace pool: hand it back unused
+        cp "$workspace/.repo_root" "$workspace/.jj/pooled" 2>/dev/null || true
+    elif [[ -n "$workspace" && -d "$workspace" ]]; then
+        rm -f "$workspace/.repo_root"
+        rmdir "$workspace" 2>/dev/null || true
+    fi
+    rm -rf "$slot"
+}
+
+# pool_lease <agent> <agent-file> - claim a ready slot, print its path
+pool_lease() {
+    local agent="$1" agent_file="$2"
+    local dir="$POOL_DIR/$agent"
+    [[ -d "$dir/ready" ]] || return 1
+
+    local repo_root
+    repo_root=$(git rev-parse --show-toplevel 2>/dev/null || pwd)
+
+    mkdir -p "$dir/leased"
+    local slot leased
+    for slot in "$dir/ready"/*; do
+        [[ -d "$slot" ]] || continue
+        leased="$dir/leased/${slot##*/}"
+        # rename(2) is atomic: exactly one caller wins each slot
+        mv "$slot" "$leased" 2>/dev/null || continue
+
+        if pool_stale "$leased" "$agent_file" || [[ "$(cat "$leased/repo_root" 2>/dev/null)" != "$repo_root" ]]; then
+            pool_discard "$leased"
+            continue
+        fi
+        echo "$leased"
+        return 0
+    done
+    return 1
+}
+
+# pool_refill <agent> - top the pool up in the background
+pool_refill() {
+    # Not part of the caller's startup: keep it out of its trace run
+    ZENIX_TRACE_RUN= ZENIX_TRACE=0 \
+        nohup "$_POOL_AGENT_DIR/scripts/pool.sh" fill "$1" >/dev/null 2>&1 &
+}
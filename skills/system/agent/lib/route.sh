@@ -0,0 +1,136 @@
+#!/bin/bash
+# Model routing for dispatch.sh (runs recorded by scripts/router.py)
+#
+# Usage (after config_load provider.yaml):
+#   source "$AGENT_DIR/lib/route.sh"
+#   route_pick MODEL <tier> <est-tokens>   # MODEL=first choice, ZENIX_ROUTE=all, in order
+#   route_pinned <alias>                   # ZENIX_ROUTE=alias + its fallback models
+#   route_resolve <alias> <tier> <headless> <est-tokens>  # MODEL_ALIAS + ZENIX_ROUTE
+#   route_lease [args]                     # route a leased pool slot (lib/pool.sh)
+#   route_exec <framework-script> [args]   # headless (-p): via router.py; else exec
+#
+# Picking never forks: rolling stats come from a sourced summary that
+# router.py rewrites after each headless run.
+#
+#   zr_<alias>_ok    1 within max_error_rate / max_p50_ms (0 otherwise)
+#   zr_<alias>_cool  avoid until (epoch), set by a 429
+
+ROUTER_DATA="$ZENIX_ROOT/data/agent/router"
+_ROUTE_AGENT_DIR="${BASH_SOURCE[0]%/*}/.."
+ROUTE_TIERS="light standard deep"
+
+# shellcheck disable=SC1091
+[[ -f "$ROUTER_DATA/summary.sh" ]] && source "$ROUTER_DATA/summary.sh"
+
+# route_healthy <alias> - not cooling down after a 429, within the error
+# rate and latency limits (checked by router.py when it wrote the summary)
+route_healthy() {
+    local key="zr_${1//[^a-zA-Z0-9]/_}"
+    local ok="${key}_ok" cool="${key}_cool"
+    [[ "${!ok:-1}" == 1 ]] || return 1
+    if [[ -n "${!cool:-}" ]]; then
+        [[ "${!cool}" -gt "${EPOCHSECONDS:-$(date +%s)}" ]] && return 1
+    fi
+    return 0
+}
+
+# _route_order <alias>... - ZENIX_ROUTE: healthy first, input order, no repeats
+_route_order() {
+    local m healthy=" " rest=" "
+    for m in "$@"; do
+        [[ "$healthy$rest" == *" $m "* ]] && continue
+        if route_healthy "$m"; then healthy+="$m "; else rest+="$m "; fi
+    done
+    ZENIX_ROUTE="${healthy# }${rest# }"
+    ZENIX_ROUTE="${ZENIX_ROUTE% }"
+}
+
+# route_pick <var> <tier> <est-tokens>
+route_pick() {
+    local tier="$2" tokens="$3" t limit models=() list m seen=false
+    for t in $ROUTE_TIERS; do
+        [[ "$t" == "$tier" ]] && seen=true
+        $seen || continue
+        # Prompt too large for this tier: move up
+        config_read limit "routing.size.$t" 0
+        [[ "$limit" -gt 0 && "$tokens" -gt "$limit" && "$t" != deep ]] && continue
+        config_read list "routing.tiers.$t"
+        for m in $list; do models+=("$m"); done
+    done
+    # Unknown tier: every tier, lightest first
+    if [[ ${#models[@]} -eq 0 ]]; then
+        for t in $ROUTE_TIERS; do
+            config_read list "routing.tiers.$t"
+            for m in $list; do models+=("$m"); done
+        done
+    fi
+    _route_order ${models[@]+"${models[@]}"}
+    printf -v "$1" '%s' "${ZENIX_ROUTE%% *}"
+}
+
+# route_pinned <alias> - the pinned model, then its fallback (failover only)
+route_pinned() {
+    local fallback m
+    config_read fallback "models.$1.fallback"
+    ZENIX_ROUTE="$1"
+    for m in $fallback; do
+        [[ " $ZENIX_ROUTE " == *" $m "* ]] || ZENIX_ROUTE+=" $m"
+    done
+}
+
+# route_resolve <pinned-alias> <tier> <headless:true|false> <est-tokens>
+# MODEL_ALIAS: pinned (--model), else routed by tier and prompt size.
+# Interactive runs without a tier keep defaults.model.
+route_resolve() {
+    local tier="$2"
+    MODEL_ALIAS="$1"
+    ZENIX_ROUTE=""
+    if [[ -n "$MODEL_ALIAS" ]]; then
+        route_pinned "$MODEL_ALIAS"
+    elif [[ -n "$tier" ]] || $3; then
+        [[ -n "$tier" ]] || config_read tier routing.default_tier standard
+        route_pick MODEL_ALIAS "$tier" "$4"
+        if [[ -z "$MODEL_ALIAS" ]]; then
+            config_read MODEL_ALIAS defaults.model opus
+            route_pinned "$MODEL_ALIAS"
+        fi
+    else
+        config_read MODEL_ALIAS defaults.model opus
+        route_pinned "$MODEL_ALIAS"
+    fi
+}
+
+# route_lease [args...] - pick the model for a leased pool slot. The slot
+# keeps the routing inputs (ROUTE_PIN, ROUTE_TIER, ROUTE_FRAMEWORK), not the
+# decision: health and prompt size are only known now.
+route_lease() {
+    local headless=false chars=${#ZENIX_SYSTEM_PROMPT} arg framework
+    for arg in "$@"; do
+        [[ "$arg" == "-p" ]] && headless=true
+        chars=$((chars + ${#arg}))
+    done
+    route_resolve "${ROUTE_PIN:-}" "${ROUTE_TIER:-}" $headless $((chars / 4))
+    if [[ -n "${ROUTE_FRAMEWORK:-}" ]]; then
+        ZENIX_ROUTE="$MODEL_ALIAS"
+    else
+        config_read framework "models.$MODEL_ALIAS.framework" claude-code
+        if [[ "$framework" != "$ZENIX_FRAMEWORK" ]]; then
+            FRAMEWORK_SCRIPT="${FRAMEWORK_SCRIPT%/*}/$framework.sh"
+            ZENIX_FRAMEWORK="$framework"
+        fi
+    fi
+    config_read ZENIX_MODEL_ID "models.$MODEL_ALIAS.model" "$MODEL_ALIAS"
+    export ZENIX_MODEL_ALIAS="$MODEL_ALIAS" ZENIX_MODEL_ID ZENIX_ROUTE ZENIX_FRAMEWORK
+}
+
+# route_exec <framework-script> [args...]
+route_exec() {
+    local script="$1" arg
+    shift
+    for arg in "$@"; do
+        if [[ "$arg" == "-p" && -n "${ZENIX_ROUTE:-}" ]]; then
+            exec python3 "$_ROUTE_AGENT_DIR/scripts/router.py" run "$script" "$@"
+        fi
+    done
+    exec "$script" "$@"
+}
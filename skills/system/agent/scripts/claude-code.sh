@@ -15,6 +15,7 @@ set -euo pipefail
 
 SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
 SESSION_SCRIPT="$SCRIPT_DIR/claude-session.sh"
+source "$ZENIX_ROOT/skills/system/zenix/lib/trace.sh"
 
 # ─────────────────────────────────────────────────────────────
 # Session management
@@ -159,4 +160,5 @@ if [[ -n "$PROMPT" ]]; then
 fi
 
 # Execute
+trace_mark claude-code.args
 exec claude "${CLAUDE_ARGS[@]}"
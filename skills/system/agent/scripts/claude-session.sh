@@ -4,16 +4,18 @@
 # Usage:
 #   session.sh find <partial> [--path]   Find session by partial ID
 #   session.sh list [n]                  List recent n sessions (default 10)
+#   session.sh tail <session> [n]        Last n turns of a transcript
+#   session.sh range <session> <a> [b]   Raw transcript lines a..b
+#   session.sh stats <session>           Tokens, tool calls, messages
+#
+# <session> is a partial ID or a .jsonl path (see transcript.py).
 
 set -euo pipefail
 
-# ─────────────────────────────────────────────────────────────
-# Helpers
-# ─────────────────────────────────────────────────────────────
-
-get_date() {
-    stat -f "%Sm" -t "$1" "$2" 2>/dev/null || echo "?"
-}
+# Session lookups go through the index (session-index.py), which never
+# opens the session files themselves
+SESSION_INDEX="$(cd "$(dirname "$0")" && pwd)/session-index.py"
+TRANSCRIPT="$(cd "$(dirname "$0")" && pwd)/transcript.py"
 
 # ─────────────────────────────────────────────────────────────
 # find - Search all projects for partial ID match
@@ -30,16 +32,15 @@ cmd_find() {
 
     local all_matches=()
     local all_paths=()
+    local all_info=()
 
-    while IFS= read -r file; do
-        [[ -z "$file" ]] && continue
-        local name
-        name=$(basename "$file" .jsonl)
-        if [[ "$name" == *"$partial"* ]]; then
-            all_matches+=("$name")
-            all_paths+=("$file")
-        fi
-    done < <(find ~/.claude/projects -name "*.jsonl" -type f 2>/dev/null | xargs ls -t 2>/dev/null)
+    local id path date size
+    while IFS=$'\t' read -r id path date size; do
+        [[ -z "$id" ]] && continue
+        all_matches+=("$id")
+        all_paths+=("$path")
+        all_info+=("$date, $size")
+    done < <(python3 "$SESSION_INDEX" find "$partial" 2>/dev/null)
 
     local count=${#all_matches[@]}
 
@@ -50,12 +51,7 @@ cmd_find() {
         echo "Multiple sessions match '$partial':" >&2
         for i in "${!all_matches[@]}"; do
             [[ $i -ge 5 ]] && break
-            local file="${all_paths[$i]}"
-            local date
-            date=$(get_date "%Y-%m-%d %H:%M" "$file")
-            local size
-            size=$(stat -f "%z" "$file" 2>/dev/null | awk '{printf "%.0fk", $1/1024}')
-            echo "  ${all_matches[$i]:0:12}... ($date, $size)" >&2
+            echo "  ${all_matches[$i]:0:12}... (${all_info[$i]})" >&2
         done
         [[ "$count" -gt 5 ]] && echo "  ... and $((count - 5)) more" >&2
         exit 1
@@ -77,58 +73,54 @@ cmd_list() {
     local limit="${1:-10}"
     local current_project
     current_project=$(pwd | sed 's|/|-|g')
-    local sessions_dir="$HOME/.claude/projects/$current_project"
 
     # Colors
     local DIM='\033[0;90m'
     local NC='\033[0m'
     local BLUE='\033[0;34m'
 
-    if [[ ! -d "$sessions_dir" ]]; then
-        echo "  (no sessions)"
-        exit 0
-    fi
+    local count=0 id date summary
+    while IFS=$'\t' read -r id date summary; do
+        count=$((count + 1))
 
-    local count=0
-    for file in $(ls -t "$sessions_dir"/*.jsonl 2>/dev/null); do
-        [[ $count -ge $limit ]] && break
-        ((count++))
-
-        local name
-        name=$(basename "$file" .jsonl)
-        local short_id="${name:0:8}"
-
-        local date
-        date=$(get_date "%m-%d %H:%M" "$file")
-
-        # Extract first user message as summary (truncate to 50 chars)
-        local summary
-        summary=$(grep -m1 '"type":"user"' "$file" 2>/dev/null | \
-            sed -n 's/.*"content":"\([^"]*\)".*/\1/p' | \
-            head -1 | \
-            cut -c1-50 | \
-            tr '\n' ' ') || true
-
-        # Fallback: try to get content from array format
-        if [[ -z "$summary" ]]; then
-            summary=$(grep -m1 '"type":"user"' "$file" 2>/dev/null | \
-                sed -n 's/.*"text":"\([^"]*\)".*/\1/p' | \
-                head -1 | \
-                cut -c1-50 | \
-                tr '\n' ' ') || true
+        # First user message as summary (truncate to 50 chars)
+        if [[ ${#summary} -gt 50 ]]; then
+            summary="${summary:0:50}..."
         fi
-
-        # Clean up summary
-        summary="${summary//\\n/ }"
-        [[ ${#summary} -eq 50 ]] && summary="${summary}..."
         [[ -z "$summary" ]] && summary="(no prompt)"
 
-        printf "${BLUE}%s${NC}  ${DIM}%s${NC}  %s\n" "$short_id" "$date" "$summary"
-    done
+        printf "${BLUE}%s${NC}  ${DIM}%s${NC}  %s\n" "${id:0:8}" "$date" "$summary"
+    done < <(python3 "$SESSION_INDEX" list --project "$current_project" "$limit" 2>/dev/null)
 
+    [[ $count -eq 0 ]] && echo "  (no sessions)"
     exit 0
 }
 
+# ─────────────────────────────────────────────────────────────
+# tail / range / stats - Read a transcript without loading it whole
+# ─────────────────────────────────────────────────────────────
+
+# transcript_path <session> - .jsonl path from a path or partial ID
+transcript_path() {
+    if [[ -f "$1" ]]; then
+        echo "$1"
+    else
+        (cmd_find "$1" --path) | sed -n 2p
+    fi
+}
+
+cmd_transcript() {
+    local cmd="$1" session="${2:-}"
+    if [[ -z "$session" ]]; then
+        echo "Usage: session.sh $cmd <partial|path> ..." >&2
+        exit 1
+    fi
+    local path
+    path=$(transcript_path "$session")
+    [[ -n "$path" ]] || exit 1
+    exec python3 "$TRANSCRIPT" "$cmd" "$path" "${@:3}"
+}
+
 # ─────────────────────────────────────────────────────────────
 # Main
 # ─────────────────────────────────────────────────────────────
@@ -140,6 +132,9 @@ case "${1:-help}" in
     list)
         cmd_list "${@:2}"
         ;;
+    tail|range|stats)
+        cmd_transcript "$@"
+        ;;
     -h|--help|help|"")
         cat <<'EOF'
 session.sh - Find and list Claude sessions
@@ -148,16 +143,24 @@ Usage:
   session.sh find <partial>          Find session, return full ID
   session.sh find <partial> --path   Also return file path
   session.sh list [n]                List recent n sessions
+  session.sh tail <session> [n]      Last n turns (--raw for JSON lines)
+  session.sh range <session> <a> [b] Raw transcript lines a..b
+  session.sh stats <session>         Tokens, tool calls (--json)
+
+Sessions come from an index in ~/.cache/zenix/sessions.tsv
+(session-index.py), refreshed by the SessionEnd hook and a watcher.
 
 Examples:
   session.sh find abc123
   session.sh find 4ee9 --path
   session.sh list 5
+  session.sh tail 4ee9 20
+  session.sh stats 4ee9
 EOF
         ;;
     *)
         echo "Unknown command: $1" >&2
-        echo "Usage: session.sh {find|list|help}" >&2
+        echo "Usage: session.sh {find|list|tail|range|stats|help}" >&2
         exit 1
         ;;
 esac
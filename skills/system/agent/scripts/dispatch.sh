@@ -6,6 +6,11 @@
 # Usage:
 #   dispatch.sh <model-alias> [args...]
 #   dispatch.sh --framework <name> [args...]
+#   dispatch.sh --tier light|standard|deep [args...]
+#
+# Without --model, the model is routed (lib/route.sh): by tier, prompt size
+# and recorded health. Headless runs (-p) go through scripts/router.py,
+# which fails over to the next model on a 429 / overload.
 #
 set -euo pipefail
 
@@ -32,195 +37,20 @@ get_workspace_prefix() {
 }
 
 # ─────────────────────────────────────────────────────────────
-# Config parsing
+# Config (parsed once into the zenix config cache)
 # ─────────────────────────────────────────────────────────────
 
-# Get value from models.<alias>.<key>
-get_model_config() {
-    local alias="$1"
-    local key="$2"
-    local fallback="${3:-}"
-
-    [[ ! -f "$CONFIG_FILE" ]] && echo "$fallback" && return
-
-    local in_models=false
-    local in_alias=false
-    local value=""
-
-    while IFS= read -r line; do
-        # Find models: block
-        if [[ "$line" =~ ^models: ]]; then
-            in_models=true
-            continue
-        fi
-
-        # Exit models on another top-level key
-        if [[ "$in_models" == true && "$line" =~ ^[a-z] ]]; then
-            break
-        fi
-
-        if [[ "$in_models" == true ]]; then
-            # Find alias (2-space indent)
-            if [[ "$line" =~ ^[[:space:]]{2}${alias}: ]]; then
-                in_alias=true
-                continue
-            fi
-
-            # Exit alias on another 2-space key
-            if [[ "$in_alias" == true && "$line" =~ ^[[:space:]]{2}[a-z] ]]; then
-                break
-            fi
-
-            # Find key (4-space indent)
-            if [[ "$in_alias" == true && "$line" =~ ^[[:space:]]{4}${key}:[[:space:]]*(.*)$ ]]; then
-                value="${BASH_REMATCH[1]}"
-                value="${value%%#*}"
-                value="$(echo "$value" | xargs)"
-                break
-            fi
-        fi
-    done < "$CONFIG_FILE"
-
-    [[ -n "$value" ]] && echo "$value" || echo "$fallback"
-}
-
-# Get value from frameworks.<name>.<key>
-get_framework_config() {
-    local name="$1"
-    local key="$2"
-    local fallback="${3:-}"
-
-    [[ ! -f "$CONFIG_FILE" ]] && echo "$fallback" && return
-
-    local in_frameworks=false
-    local in_name=false
-    local value=""
-
-    while IFS= read -r line; do
-        if [[ "$line" =~ ^frameworks: ]]; then
-            in_frameworks=true
-            continue
-        fi
-
-        if [[ "$in_frameworks" == true && "$line" =~ ^[a-z] ]]; then
-            break
-        fi
-
-        if [[ "$in_frameworks" == true ]]; then
-            if [[ "$line" =~ ^[[:space:]]{2}${name}: ]]; then
-                in_name=true
-                continue
-            fi
-
-            if [[ "$in_name" == true && "$line" =~ ^[[:space:]]{2}[a-z] ]]; then
-                break
-            fi
-
-            if [[ "$in_name" == true && "$line" =~ ^[[:space:]]{4}${key}:[[:space:]]*(.*)$ ]]; then
-                value="${BASH_REMATCH[1]}"
-                value="${value%%#*}"
-                value="$(echo "$value" | xargs)"
-                break
-            fi
-        fi
-    done < "$CONFIG_FILE"
-
-    [[ -n "$value" ]] && echo "$value" || echo "$fallback"
-}
-
-# Get nested value from frameworks.<name>.<section>.<key>
-get_framework_nested() {
-    local name="$1"
-    local section="$2"
-    local key="$3"
-    local fallback="${4:-}"
-
-    [[ ! -f "$CONFIG_FILE" ]] && echo "$fallback" && return
-
-    local in_frameworks=false
-    local in_name=false
-    local in_section=false
-    local value=""
-
-    while IFS= read -r line; do
-        if [[ "$line" =~ ^frameworks: ]]; then
-            in_frameworks=true
-            continue
-        fi
-
-        if [[ "$in_frameworks" == true && "$line" =~ ^[a-z] ]]; then
-            break
-        fi
-
-        if [[ "$in_frameworks" == true ]]; then
-            if [[ "$line" =~ ^[[:space:]]{2}${name}: ]]; then
-                in_name=true
-                continue
-            fi
-
-            if [[ "$in_name" == true && "$line" =~ ^[[:space:]]{2}[a-z] ]]; then
-                break
-            fi
-
-            if [[ "$in_name" == true ]]; then
-                if [[ "$line" =~ ^[[:space:]]{4}${section}: ]]; then
-                    in_section=true
-                    continue
-                fi
-
-                if [[ "$in_section" == true && "$line" =~ ^[[:space:]]{4}[a-z] ]]; then
-                    break
-                fi
-
-                if [[ "$in_section" == true && "$line" =~ ^[[:space:]]{6}${key}:[[:space:]]*(.*)$ ]]; then
-                    value="${BASH_REMATCH[1]}"
-                    value="${value%%#*}"
-                    value="$(echo "$value" | xargs)"
-                    break
-                fi
-            fi
-        fi
-    done < "$CONFIG_FILE"
-
-    [[ -n "$value" ]] && echo "$value" || echo "$fallback"
-}
-
-# Get default value
-get_default() {
-    local key="$1"
-    local fallback="${2:-}"
-
-    [[ ! -f "$CONFIG_FILE" ]] && echo "$fallback" && return
-
-    local in_defaults=false
-    local value=""
-
-    while IFS= read -r line; do
-        if [[ "$line" =~ ^defaults: ]]; then
-            in_defaults=true
-            continue
-        fi
-
-        if [[ "$in_defaults" == true && "$line" =~ ^[a-z] ]]; then
-            break
-        fi
-
-        if [[ "$in_defaults" == true && "$line" =~ ^[[:space:]]{2}${key}:[[:space:]]*(.*)$ ]]; then
-            value="${BASH_REMATCH[1]}"
-            value="${value%%#*}"
-            value="$(echo "$value" | xargs)"
-            break
-        fi
-    done < "$CONFIG_FILE"
-
-    [[ -n "$value" ]] && echo "$value" || echo "$fallback"
-}
+source "$ZENIX_ROOT/skills/system/zenix/lib/trace.sh"
+source "$ZENIX_ROOT/skills/system/zenix/lib/config.sh"
+config_load "$CONFIG_FILE" || true
+source "$AGENT_DIR/lib/route.sh"
 
 # ─────────────────────────────────────────────────────────────
 # Main dispatch logic
 # ─────────────────────────────────────────────────────────────
 
 MODEL_ALIAS=""
+TIER=""
 FRAMEWORK=""
 PERMISSIONS=""
 SYSTEM_PROMPT=""
@@ -238,6 +68,10 @@ while [[ $# -gt 0 ]]; do
             MODEL_ALIAS="$2"
             shift 2
             ;;
+        --tier)
+            TIER="$2"
+            shift 2
+            ;;
         --permissions)
             PERMISSIONS="$2"
             shift 2
@@ -257,39 +91,53 @@ while [[ $# -gt 0 ]]; do
     esac
 done
 
-# Resolve model alias to framework
-if [[ -z "$MODEL_ALIAS" ]]; then
-    MODEL_ALIAS=$(get_default "model" "opus")
-fi
+# Resolve model (lib/route.sh). A pool fill keeps the inputs instead: the
+# slot is routed when it is leased, with the real prompt.
+HEADLESS=false
+PROMPT_CHARS=${#SYSTEM_PROMPT}
+for arg in ${PASSTHROUGH_ARGS[@]+"${PASSTHROUGH_ARGS[@]}"}; do
+    [[ "$arg" == "-p" ]] && HEADLESS=true
+    PROMPT_CHARS=$((PROMPT_CHARS + ${#arg}))
+done
+
+ROUTE_PIN="$MODEL_ALIAS"
+ROUTE_TIER="$TIER"
+ROUTE_FRAMEWORK="$FRAMEWORK"
+route_resolve "$ROUTE_PIN" "$TIER" $HEADLESS $((PROMPT_CHARS / 4))
 
 if [[ -z "$FRAMEWORK" ]]; then
-    FRAMEWORK=$(get_model_config "$MODEL_ALIAS" "framework" "claude-code")
+    config_read FRAMEWORK "models.$MODEL_ALIAS.framework" claude-code
+else
+    # Framework pinned too: no failover to other models' frameworks
+    ZENIX_ROUTE="$MODEL_ALIAS"
 fi
 
 # Validate framework exists
-COMMAND=$(get_framework_config "$FRAMEWORK" "command" "")
+config_read COMMAND "frameworks.$FRAMEWORK.command"
 if [[ -z "$COMMAND" ]]; then
     echo "Unknown framework: $FRAMEWORK" >&2
     exit 1
 fi
 
 # Resolve model ID from alias
-MODEL_ID=$(get_model_config "$MODEL_ALIAS" "model" "$MODEL_ALIAS")
+config_read MODEL_ID "models.$MODEL_ALIAS.model" "$MODEL_ALIAS"
 
 # Resolve permissions (arg > default)
 if [[ -z "$PERMISSIONS" ]]; then
-    PERMISSIONS=$(get_default "permissions" "auto")
+    config_read PERMISSIONS defaults.permissions auto
 fi
 
 # Resolve workspace
-WORKSPACE_ENABLED=$(get_default "workspace" "true")
+config_read WORKSPACE_ENABLED defaults.workspace true
 
 # Derive workspace prefix (or use explicit override)
-WORKSPACE_PREFIX=$(get_framework_config "$FRAMEWORK" "workspace_prefix" "")
+config_read WORKSPACE_PREFIX "frameworks.$FRAMEWORK.workspace_prefix"
 if [[ -z "$WORKSPACE_PREFIX" ]]; then
     WORKSPACE_PREFIX=$(get_workspace_prefix "$FRAMEWORK")
 fi
 
+trace_mark dispatch.config
+
 # Generate session ID and workspace path
 SESSION_ID=$(openssl rand -hex 4)
 WORKSPACE_NAME="${WORKSPACE_PREFIX}-${SESSION_ID}"
@@ -300,13 +148,30 @@ REPO_ROOT=$(git rev-parse --show-toplevel 2>/dev/null || pwd)
 
 # ─────────────────────────────────────────────────────────────
 # Create workspace directory (if enabled)
-# Note: jj workspace is created lazily by `work on` on first use
+# Claims a pre-provisioned jj workspace when defaults.workspace_pool > 0
+# (work/lib/workspace-pool.sh); its <prefix>-<hex> name sets the session id.
+# Otherwise the jj workspace is created lazily by `work on` on first use
 # ─────────────────────────────────────────────────────────────
 
 if [[ "$WORKSPACE_ENABLED" == "true" ]]; then
-    mkdir -p "$WORKSPACE_PATH"
-    echo "$REPO_ROOT" > "$WORKSPACE_PATH/.repo_root"
+    config_read WORKSPACE_POOL defaults.workspace_pool 0
+    CLAIMED=""
+    if [[ "$WORKSPACE_POOL" =~ ^[1-9] && -d "$REPO_ROOT/.jj" ]]; then
+        source "$ZENIX_ROOT/skills/system/work/lib/workspace-pool.sh"
+        CLAIMED=$(work_pool_claim "$WORKSPACE_PREFIX" "$REPO_ROOT") || true
+        work_pool_refill "$WORKSPACE_PREFIX" "$REPO_ROOT"
+    fi
+
+    if [[ -n "$CLAIMED" ]]; then
+        WORKSPACE_PATH="$CLAIMED"
+        WORKSPACE_NAME="${CLAIMED##*/}"
+        SESSION_ID="${WORKSPACE_NAME#"$WORKSPACE_PREFIX"-}"
+    else
+        mkdir -p "$WORKSPACE_PATH"
+        echo "$REPO_ROOT" > "$WORKSPACE_PATH/.repo_root"
+    fi
 fi
+trace_mark dispatch.workspace
 
 # ─────────────────────────────────────────────────────────────
 # Export unified interface for framework parsers
@@ -324,6 +189,7 @@ export ZENIX_REPO_ROOT="$REPO_ROOT"
 # Model
 export ZENIX_MODEL_ALIAS="$MODEL_ALIAS"
 export ZENIX_MODEL_ID="$MODEL_ID"
+export ZENIX_ROUTE
 
 # Behavior
 export ZENIX_PERMISSIONS="$PERMISSIONS"
@@ -337,15 +203,33 @@ export ZENIX_SKILLS="$SKILLS"
 # ─────────────────────────────────────────────────────────────
 
 "$ZENIX_ROOT/skills/system/hook/scripts/build.sh" >/dev/null 2>&1 || true
+trace_mark dispatch.hooks
 
 # ─────────────────────────────────────────────────────────────
 # Execute framework parser
 # ─────────────────────────────────────────────────────────────
 
 FRAMEWORK_SCRIPT="$SCRIPT_DIR/${FRAMEWORK}.sh"
-if [[ -x "$FRAMEWORK_SCRIPT" ]]; then
-    exec "$FRAMEWORK_SCRIPT" ${PASSTHROUGH_ARGS[@]+"${PASSTHROUGH_ARGS[@]}"}
-else
+if [[ ! -x "$FRAMEWORK_SCRIPT" ]]; then
     echo "Framework script not found: $FRAMEWORK_SCRIPT" >&2
     exit 1
 fi
+
+# Pool fill (lib/pool.sh): save the prepared session instead of launching
+if [[ -n "${ZENIX_PREPARE:-}" ]]; then
+    {
+        for var in ZENIX_SESSION_ID ZENIX_FRAMEWORK ZENIX_WORKSPACE_PATH ZENIX_WORKSPACE_ENABLED \
+                   ZENIX_REPO_ROOT ZENIX_PERMISSIONS ZENIX_SYSTEM_PROMPT ZENIX_SKILLS; do
+            printf 'export %s=%q\n' "$var" "${!var}"
+        done
+        # Model and route are picked at lease time (route_lease)
+        for var in ROUTE_PIN ROUTE_TIER ROUTE_FRAMEWORK FRAMEWORK_SCRIPT; do
+            printf '%s=%q\n' "$var" "${!var}"
+        done
+    } > "$ZENIX_PREPARE/env.sh"
+    echo "$REPO_ROOT" > "$ZENIX_PREPARE/repo_root"
+    [[ "$WORKSPACE_ENABLED" == "true" ]] && echo "$WORKSPACE_PATH" > "$ZENIX_PREPARE/workspace"
+    exit 0
+fi
+
+route_exec "$FRAMEWORK_SCRIPT" ${PASSTHROUGH_ARGS[@]+"${PASSTHROUGH_ARGS[@]}"}
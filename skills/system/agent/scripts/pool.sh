@@ -0,0 +1,127 @@
+#!/bin/bash
+#
+# Warm agent pool management (see lib/pool.sh)
+#
+# Usage:
+#   pool.sh fill [agent...]     Prepare slots up to each agent's pool size
+#   pool.sh status              Show ready/leased slots per agent
+#   pool.sh drain [agent...]    Discard ready slots (and their workspaces)
+#
+# Pool size: `pool:` in agents/<name>.md frontmatter, else `defaults.pool`
+# in config/provider.yaml (0 = no pool).
+#
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+AGENT_DIR="$(dirname "$SCRIPT_DIR")"
+
+source "$ZENIX_ROOT/skills/system/zenix/lib/output.sh"
+source "$ZENIX_ROOT/skills/system/zenix/lib/config.sh"
+source "$ZENIX_ROOT/skills/system/zenix/lib/skill-index.sh"
+source "$AGENT_DIR/lib/pool.sh"
+
+skill_index_load
+config_load "$AGENT_DIR/config/provider.yaml" || true
+
+pool_size() {
+    local size
+    agent_lookup size "$1" pool
+    [[ -z "$size" ]] && config_read size defaults.pool 0
+    [[ "$size" =~ ^[0-9]+$ ]] || size=0
+    echo "$size"
+}
+
+count_slots() {
+    local n=0 slot
+    for slot in "$1"/*; do
+        [[ -d "$slot" ]] && n=$((n + 1))
+    done
+    echo "$n"
+}
+
+# Agents to act on: args, else every agent in the index
+agent_names() {
+    if [[ $# -gt 0 ]]; then
+        echo "$@"
+    else
+        echo "$ZENIX_AGENT_NAMES"
+    fi
+}
+
+cmd_fill() {
+    local agent
+    for agent in $(agent_names "$@"); do
+        local size dir
+        size=$(pool_size "$agent")
+        [[ "$size" -gt 0 ]] || continue
+        dir="$POOL_DIR/$agent"
+        mkdir -p "$dir/ready" "$dir/.filling"
+
+        # One filler per agent; a concurrent lease's refill just skips
+        mkdir "$dir/.fill.lock" 2>/dev/null || continue
+        trap 'rmdir "$dir/.fill.lock" 2>/dev/null || true' EXIT
+
+        local n=0
+        while [[ $(count_slots "$dir/ready") -lt "$size" ]]; do
+            local slot="$dir/.filling/$(date +%s)-$$-$n"
+            n=$((n + 1))
+            mkdir -p "$slot"
+            if ZENIX_PREPARE="$slot" "$AGENT_DIR/run" -A "$agent" >/dev/null 2>&1 && [[ -f "$slot/env.sh" ]]; then
+                mv "$slot" "$dir/ready/"
+            else
+                pool_discard "$slot"
+                err "Failed to prepare slot for $agent"
+                break
+            fi
+        done
+
+        rmdir "$dir/.fill.lock" 2>/dev/null || true
+        trap - EXIT
+        ok "$agent: $(count_slots "$dir/ready")/$size ready"
+    done
+}
+
+cmd_status() {
+    local agent found=false
+    for agent in $ZENIX_AGENT_NAMES; do
+        local size dir
+        size=$(pool_size "$agent")
+        dir="$POOL_DIR/$agent"
+        [[ "$size" -gt 0 || -d "$dir" ]] || continue
+        found=true
+        echo -e "  ${GREEN}${agent}${NC} $(count_slots "$dir/ready")/$size ready, $(count_slots "$dir/leased") leased"
+    done
+    $found || echo "  No pooled agents (set pool: N in agents/<name>.md)"
+}
+
+cmd_drain() {
+    local agent
+    for agent in $(agent_names "$@"); do
+        local dir="$POOL_DIR/$agent" slot n=0
+        for slot in "$dir/ready"/* "$dir/.filling"/*; do
+            [[ -d "$slot" ]] || continue
+            pool_discard "$slot"
+            n=$((n + 1))
+        done
+        [[ $n -gt 0 ]] && ok "$agent: drained $n slot(s)"
+    done
+    return 0
+}
+
+case "${1:-}" in
+    fill)
+        shift
+        cmd_fill "$@"
+        ;;
+    status)
+        cmd_status
+        ;;
+    drain)
+        shift
+        cmd_drain "$@"
+        ;;
+    *)
+        echo "Usage: agent pool <fill|status|drain> [agent...]"
+        exit 1
+        ;;
+esac
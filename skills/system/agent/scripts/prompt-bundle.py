@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+prompt-bundle - Compile the system prompt of an agent launch once, to disk.
+
+A bundle is the exact --system-prompt text for one (agent, skills spec):
+
+    # Skills
+
+    [core]
+    daily: ...
+    vault: ...
+
+    <agent body>
+
+The skills section comes first and depends only on the spec, so every agent
+with the same spec shares a byte-identical prefix, and a bundle is identical
+from run to run: skills sorted by category then name, no colours, no
+footer. That keeps provider-side prompt caching hitting across heartbeat and
+vault triggers.
+
+Bundles live in $ZENIX_CACHE/prompts/<agent>--<spec>.md (agent "_" for
+none). agent/run reuses one while it is newer than the skill index and the
+agent file, so a SKILL.md or agents/*.md change (which rewrites the index)
+rebuilds it.
+
+Usage:
+    prompt-bundle.py build <bundle> <agent-file|-> <skills-spec>
+"""
+
+import json
+import os
+import sys
+
+sys.dont_write_bytecode = True
+
+CACHE_DIR = os.environ.get("ZENIX_CACHE", os.path.expanduser("~/.cache/zenix"))
+INDEX_JSON = os.path.join(CACHE_DIR, "skills.json")
+
+
+def agent_body(path: str) -> str:
+    """Agent file without its frontmatter (same as get_prompt_body in run)."""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        lines = f.read().split("\n")
+    if lines and lines[0] == "---":
+        try:
+            lines = lines[lines.index("---", 1) + 1:]
+        except ValueError:
+            lines = []
+    return "\n".join(lines).strip("\n")
+
+
+def skills_section(spec: str) -> str:
+    filters = [f for f in spec.replace(",", " ").split() if f]
+    if not filters or filters == ["none"]:
+        return ""
+    if filters[0] == "all":
+        filters = []
+    try:
+        with open(INDEX_JSON) as f:
+            skills = json.load(f)["skills"].values()
+    except (OSError, ValueError, KeyError):
+        return ""
+
+    rows = []
+    for s in skills:
+        if filters and s["category"] not in filters and s["name"] not in filters:
+            continue
+        desc = " ".join(str(s["frontmatter"].get("description") or "(no description)").split())
+        tag = "" if s["run"] else " (info only)"
+        rows.append((s["category"], s["name"], f"{s['name']}{tag}: {desc}"))
+    if not rows:
+        return ""
+
+    out, group = ["# Skills"], None
+    for category, _, line in sorted(rows):
+        if category != group:
+            out.append("")
+            out.append(f"[{category}]")
+            group = category
+        out.append(line)
+    return "\n".join(out)
+
+
+def build(bundle: str, agent_file: str, spec: str):
+    parts = [skills_section(spec)]
+    if agent_file != "-":
+        parts.append(agent_body(agent_file))
+    text = "\n\n".join(p for p in parts if p)
+    os.makedirs(os.path.dirname(bundle), exist_ok=True)
+    tmp = f"{bundle}.{os.getpid()}.tmp"
+    with open(tmp, "w", encoding="utf-8") as f:
+        f.write(text)
+    os.replace(tmp, bundle)
+
+
+def main():
+    if len(sys.argv) == 5 and sys.argv[1] == "build":
+        build(*sys.argv[2:])
+    else:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
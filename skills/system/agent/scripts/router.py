@@ -0,0 +1,328 @@
+#!/usr/bin/env python3
+"""
+router - Run a headless agent launch with failover, and keep model stats.
+
+dispatch.sh (lib/route.sh) picks the model order and exports it as
+ZENIX_ROUTE ("sonnet opus"). For a headless run (-p) it hands over here:
+each model is tried in turn, with its framework script and model id. Output
+is streamed through as it arrives. An attempt the API rejected before any
+work (non-zero exit, nothing on stdout, stderr matching routing.failover_on:
+an "API Error: 429/529" or a rate_limit/overloaded error type) fails over to
+the next model, reading the same piped stdin; anything else, including a
+kill after routing.timeout (0 = none), ends the run with its exit code.
+
+Every attempt is recorded in $ZENIX_ROOT/data/agent/router/:
+
+    <alias>.log     "epoch ms status" per attempt (ok, error, timeout, ratelimit)
+    summary.sh      zr_<alias>_{ok,cool,n,err,p50} for lib/route.sh to source
+
+over the last routing.window attempts: n runs, err percent failed, p50
+median ms of successes, ok 0 when above routing.max_error_rate or
+routing.max_p50_ms (after routing.min_samples runs), cool the epoch until
+which a rate-limited model is avoided (routing.cooldown).
+
+Each attempt also goes to the shared metrics log (zenix/lib/metrics.py)
+with its tokens and cost: claude-code runs get a --session-id, and the
+usage is read from that transcript once the attempt ends, priced with the
+model's `price:` in provider.yaml.
+
+Usage:
+    router.py run <framework-script> [args...]    Run with failover (ZENIX_ROUTE)
+    router.py record <alias> <ms> <status>        Record one attempt
+    router.py status                              Per-model stats
+"""
+
+import fcntl
+import glob
+import os
+import re
+import selectors
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+import time
+import uuid
+
+sys.dont_write_bytecode = True
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(SCRIPT_DIR, "../../zenix/lib"))
+import config_cache  # noqa: E402
+import metrics  # noqa: E402
+import transcript  # noqa: E402
+
+ZENIX_ROOT = os.environ.get("ZENIX_ROOT", os.path.expanduser("~/.zenix"))
+CONFIG_FILE = os.path.join(SCRIPT_DIR, "..", "config", "provider.yaml")
+DATA_DIR = os.path.join(ZENIX_ROOT, "data", "agent", "router")
+SUMMARY = os.path.join(DATA_DIR, "summary.sh")
+STATUSES = ("ok", "error", "timeout", "ratelimit")
+# The framework's own API error line, not any "429" in the agent's text
+FAILOVER_ON = r"API Error: .*\b(429|529)\b|\b(rate_limit|overloaded)_error\b"
+
+
+def load_config() -> dict:
+    data = config_cache.load(os.path.abspath(CONFIG_FILE))
+    return data if isinstance(data, dict) else {}
+
+
+def routing(cfg: dict, key: str, default):
+    value = (cfg.get("routing") or {}).get(key)
+    if value is None or value == "":
+        return default
+    return type(default)(value)
+
+
+def model_key(alias: str) -> str:
+    return "zr_" + re.sub(r"[^A-Za-z0-9]", "_", alias)
+
+
+# ─────────────────────────────────────────────────────────────
+# Stats
+# ─────────────────────────────────────────────────────────────
+
+def read_log(alias: str) -> list:
+    """[(epoch, ms, status)] of one model, oldest first."""
+    runs = []
+    try:
+        with open(os.path.join(DATA_DIR, f"{alias}.log")) as f:
+            for line in f:
+                parts = line.split()
+                if len(parts) == 3 and parts[2] in STATUSES:
+                    runs.append((int(parts[0]), int(parts[1]), parts[2]))
+    except (OSError, ValueError):
+        pass
+    return runs
+
+
+def stats(cfg: dict, alias: str) -> dict:
+    window = routing(cfg, "window", 50)
+    runs = read_log(alias)
+    recent = runs[-window:]
+    ok_ms = sorted(ms for _, ms, status in recent if status == "ok")
+    n = len(recent)
+    err = round(100 * sum(1 for r in recent if r[2] != "ok") / n) if n else 0
+    p50 = ok_ms[len(ok_ms) // 2] if ok_ms else 0
+    healthy = True
+    if n >= routing(cfg, "min_samples", 5):
+        if err > 100 * routing(cfg, "max_error_rate", 0.5):
+            healthy = False
+        max_p50 = routing(cfg, "max_p50_ms", 0)
+        if max_p50 and p50 > max_p50:
+            healthy = False
+    limited = [t for t, _, status in runs if status == "ratelimit"]
+    cool = limited[-1] + routing(cfg, "cooldown", 300) if limited else 0
+    return {"n": n, "err": err, "p50": p50, "ok": 1 if healthy else 0, "cool": cool}
+
+
+def write_summary(cfg: dict):
+    lines = ["# Model stats for lib/route.sh (written by scripts/router.py)"]
+    for alias in sorted(known_aliases(cfg)):
+        s = stats(cfg, alias)
+        key = model_key(alias)
+        lines += [f"{key}_{k}={s[k]}" for k in ("ok", "cool", "n", "err", "p50")]
+    tmp = f"{SUMMARY}.{os.getpid()}.tmp"
+    with open(tmp, "w") as f:
+        f.write("\n".join(lines) + "\n")
+    os.replace(tmp, SUMMARY)
+
+
+def known_aliases(cfg: dict) -> set:
+    aliases = set((cfg.get("models") or {}).keys())
+    try:
+        aliases.update(n[:-4] for n in os.listdir(DATA_DIR) if n.endswith(".log"))
+    except OSError:
+        pass
+    return aliases
+
+
+def record(cfg: dict, alias: str, ms: int, status: str):
+    os.makedirs(DATA_DIR, exist_ok=True)
+    with open(os.path.join(DATA_DIR, "lock"), "w") as lock:
+        fcntl.flock(lock, fcntl.LOCK_EX)
+        path = os.path.join(DATA_DIR, f"{alias}.log")
+        with open(path, "a") as f:
+            f.write(f"{int(time.time())} {ms} {status}\n")
+        # Keep the log a few windows long
+        runs = read_log(alias)
+        window = routing(cfg, "window", 50)
+        if len(runs) > 4 * window:
+            tmp = f"{path}.{os.getpid()}.tmp"
+            with open(tmp, "w") as f:
+                f.writelines(f"{t} {ms} {s}\n" for t, ms, s in runs[-window:])
+            os.replace(tmp, path)
+        write_summary(cfg)
+
+
+# ─────────────────────────────────────────────────────────────
+# Usage and cost
+# ─────────────────────────────────────────────────────────────
+
+TOKEN_TYPES = (("in", "input_tokens"), ("out", "output_tokens"),
+               ("cache_read", "cache_read_input_tokens"),
+               ("cache_write", "cache_creation_input_tokens"))
+# Resumed or continued sessions keep their own id (their usage is not split out)
+SESSION_FLAGS = {"--session-id", "--resume", "-r", "--continue", "-c"}
+
+
+def session_usage(session: str) -> dict:
+    """{in, out, cache_read, cache_write} of a claude session ({} if not found)."""
+    config = os.environ.get("CLAUDE_CONFIG_DIR") or os.path.expanduser("~/.claude")
+    for path in glob.glob(os.path.join(config, "projects", "*", f"{session}.jsonl")):
+        tokens = transcript.stats(path)["tokens"]
+        return {short: tokens.get(key, 0) for short, key in TOKEN_TYPES}
+    return {}
+
+
+def cost(model: dict, usage: dict) -> float:
+    """USD from `price: [input, output, cache read, cache write]` per Mtok."""
+    try:
+        price = [float(p) for p in (model.get("price") or [])]
+    except (TypeError, ValueError):
+        return 0.0
+    return sum(usage.get(short, 0) * p / 1e6 for (short, _), p in zip(TOKEN_TYPES, price))
+
+
+# ─────────────────────────────────────────────────────────────
+# Run with failover
+# ─────────────────────────────────────────────────────────────
+
+def attempt(argv: list, env: dict, timeout: float, stdin=None, tail_max: int = 8192) -> tuple:
+    """(exit code, stderr tail, stdout bytes, timed out) of one framework run.
+
+    Output is streamed to our stdout/stderr as it arrives (terminal, watcher
+    or queue log); only the last tail_max bytes of stderr are kept, for
+    failover_on.
+    """
+    proc = subprocess.Popen(argv, env=env, stdin=stdin, stdout=subprocess.PIPE,
+                            stderr=subprocess.PIPE, start_new_session=True)
+    sel = selectors.DefaultSelector()
+    sel.register(proc.stdout, selectors.EVENT_READ, sys.stdout.fileno())
+    sel.register(proc.stderr, selectors.EVENT_READ, sys.stderr.fileno())
+    deadline = time.monotonic() + timeout if timeout else None
+    tail, out, timed_out = bytearray(), 0, False
+    while sel.get_map():
+        wait = None if deadline is None else deadline - time.monotonic()
+        if wait is not None and wait <= 0:
+            timed_out = True
+            break
+        for key, _ in sel.select(wait):
+            chunk = os.read(key.fd, 65536)
+            if not chunk:
+                sel.unregister(key.fileobj)
+                continue
+            os.write(key.data, chunk)
+            if key.fileobj is proc.stdout:
+                out += len(chunk)
+            else:
+                tail += chunk
+                del tail[:-tail_max]
+    if timed_out:
+        try:
+            os.killpg(proc.pid, signal.SIGTERM)
+            proc.wait(timeout=10)
+        except ProcessLookupError:
+            pass
+        except subprocess.TimeoutExpired:
+            os.killpg(proc.pid, signal.SIGKILL)
+    sel.close()
+    code = proc.wait()
+    proc.stdout.close()
+    proc.stderr.close()
+    return (124 if timed_out else code), bytes(tail), out, timed_out
+
+
+def spool_stdin(route: list):
+    """Piped stdin, kept so every attempt reads it from the start (None: inherit)."""
+    if len(route) < 2 or sys.stdin is None or sys.stdin.isatty():
+        return None
+    f = tempfile.TemporaryFile()
+    shutil.copyfileobj(sys.stdin.buffer, f)
+    return f
+
+
+def run(script: str, args: list) -> int:
+    cfg = load_config()
+    models = cfg.get("models") or {}
+    route = os.environ.get("ZENIX_ROUTE", "").split() or [os.environ.get("ZENIX_MODEL_ALIAS", "")]
+    timeout = routing(cfg, "timeout", 0)
+    failover = re.compile(str(routing(cfg, "failover_on", FAILOVER_ON)))
+    stdin = spool_stdin(route)
+
+    code = 1
+    for i, alias in enumerate(route):
+        model = models.get(alias) or {}
+        framework = str(model.get("framework") or os.environ.get("ZENIX_FRAMEWORK", ""))
+        argv = [script if framework == os.environ.get("ZENIX_FRAMEWORK") else
+                os.path.join(SCRIPT_DIR, f"{framework}.sh")] + args
+        if not os.access(argv[0], os.X_OK):
+            print(f"router: no framework script for {alias} ({framework})", file=sys.stderr)
+            continue
+        env = dict(os.environ, ZENIX_MODEL_ALIAS=alias, ZENIX_FRAMEWORK=framework,
+                   ZENIX_MODEL_ID=str(model.get("model") or alias))
+        session = ""
+        if framework == "claude-code" and not SESSION_FLAGS.intersection(args):
+            session = str(uuid.uuid4())
+            argv[1:1] = ["--session-id", session]
+        if stdin:
+            stdin.seek(0)
+
+        started = time.monotonic()
+        code, tail, out, timed_out = attempt(argv, env, timeout, stdin)
+        ms = int((time.monotonic() - started) * 1000)
+        if timed_out:
+            status = "timeout"
+        elif code != 0 and not out and failover.search(tail.decode("utf-8", "replace")):
+            status = "ratelimit"
+        else:
+            status = "ok" if code == 0 else "error"
+        record(cfg, alias, ms, status)
+        usage = session_usage(session) if session else {}
+        metrics.record("agent", os.environ.get("ZENIX_AGENT", ""), model=alias, status=status,
+                       exit=code, ms=ms, cost=round(cost(model, usage), 6) if usage else None,
+                       watcher=os.environ.get("ZENIX_WATCHER"), **usage)
+
+        # Only a run the API rejected up front (an error on stderr, nothing
+        # on stdout yet) is retried elsewhere: one that timed out or failed
+        # later may have done part of its work (commits, writes) and must
+        # not run twice
+        if status == "ratelimit" and i + 1 < len(route):
+            print(f"router: {alias} {status} after {ms / 1000:.0f}s, failing over to {route[i + 1]}",
+                  file=sys.stderr)
+            continue
+        break
+    return code
+
+
+def status():
+    cfg = load_config()
+    tiers = (cfg.get("routing") or {}).get("tiers") or {}
+    now = time.time()
+    print(f"{'MODEL':<10} {'TIERS':<20} {'RUNS':>5} {'ERR%':>5} {'P50':>8}  STATE")
+    for alias in sorted(known_aliases(cfg)):
+        s = stats(cfg, alias)
+        in_tiers = ",".join(t for t, models in tiers.items() if alias in (models or [])) or "-"
+        state = "ok" if s["ok"] else "degraded"
+        if s["cool"] > now:
+            state = f"cooling ({int(s['cool'] - now)}s)"
+        p50 = "-" if not s["p50"] else f"{s['p50']}ms" if s["p50"] < 1000 else f"{s['p50'] / 1000:.1f}s"
+        print(f"{alias:<10} {in_tiers:<20} {s['n']:>5} {s['err']:>5} {p50:>8}  {state}")
+
+
+def main():
+    args = sys.argv[1:]
+    cmd = args[0] if args else ""
+    if cmd == "run" and len(args) >= 2:
+        sys.exit(run(args[1], args[2:]))
+    elif cmd == "record" and len(args) == 4 and args[3] in STATUSES:
+        record(load_config(), args[1], int(args[2]), args[3])
+    elif cmd == "status":
+        status()
+    else:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,252 @@
+#!/usr/bin/env python3
+"""
+session-index - Incremental index of Claude sessions for claude-session.sh.
+
+One TSV line per session in $ZENIX_CACHE/sessions.tsv, sorted by id:
+
+    id  project  mtime  size  offset  messages  first prompt
+
+Lookups never open session files: a partial id is a bisect over the sorted
+ids (prefix match, else substring), listing sorts the index by mtime.
+Updates only re-read sessions whose mtime/size changed, and a session that
+only grew is counted from the last complete line it had (offset).
+
+Kept fresh by the SessionEnd hook (daily), the session-index watcher and,
+as a last resort, a rescan when a lookup misses or a project dir is newer
+than the index.
+
+Usage:
+    session-index.py build                     Rescan every session
+    session-index.py update [<jsonl>...]       Re-index changed sessions
+    session-index.py find <partial>            id, path, date, size (newest first)
+    session-index.py list [-p <project>] [n]   id, date, prompt (newest first)
+"""
+
+import bisect
+import fcntl
+import glob
+import json
+import os
+import sys
+import time
+
+PROJECTS_DIR = os.path.expanduser("~/.claude/projects")
+CACHE_DIR = os.environ.get("ZENIX_CACHE", os.path.expanduser("~/.cache/zenix"))
+INDEX = os.path.join(CACHE_DIR, "sessions.tsv")
+PROMPT_MAX = 200
+
+FIELDS = ("id", "project", "mtime", "size", "offset", "messages", "prompt")
+
+
+# ─────────────────────────────────────────────────────────────
+# Index file
+# ─────────────────────────────────────────────────────────────
+
+def load() -> dict:
+    sessions = {}
+    try:
+        with open(INDEX, encoding="utf-8") as f:
+            for line in f:
+                parts = line.rstrip("\n").split("\t")
+                if len(parts) != len(FIELDS):
+                    continue
+                s = dict(zip(FIELDS, parts))
+                s["mtime"] = float(s["mtime"])
+                for key in ("size", "offset", "messages"):
+                    s[key] = int(s[key])
+                sessions[s["id"]] = s
+    except FileNotFoundError:
+        pass
+    return sessions
+
+
+def save(sessions: dict):
+    os.makedirs(CACHE_DIR, exist_ok=True)
+    tmp = f"{INDEX}.{os.getpid()}.tmp"
+    with open(tmp, "w", encoding="utf-8") as f:
+        for sid in sorted(sessions):
+            s = sessions[sid]
+            f.write(f"{sid}\t{s['project']}\t{s['mtime']:.3f}\t{s['size']}\t{s['offset']}\t{s['messages']}\t{s['prompt']}\n")
+    os.replace(tmp, INDEX)
+
+
+def locked(fn):
+    """Run fn(sessions) under the index lock, then save the result."""
+    os.makedirs(CACHE_DIR, exist_ok=True)
+    with open(INDEX + ".lock", "w") as lock:
+        fcntl.flock(lock, fcntl.LOCK_EX)
+        sessions = load()
+        fn(sessions)
+        save(sessions)
+    return sessions
+
+
+def session_path(s: dict) -> str:
+    return os.path.join(PROJECTS_DIR, s["project"], s["id"] + ".jsonl")
+
+
+# ─────────────────────────────────────────────────────────────
+# Session files
+# ─────────────────────────────────────────────────────────────
+
+def prompt_text(record: dict) -> str:
+    content = (record.get("message") or {}).get("content")
+    if isinstance(content, str):
+        return content
+    if isinstance(content, list):
+        for part in content:
+            if isinstance(part, dict) and part.get("type") == "text":
+                return part.get("text") or ""
+    return ""
+
+
+def scan(path: str, start: int, messages: int, prompt: str) -> tuple:
+    """Count messages (and find the first prompt) from byte offset start.
+
+    Returns (offset, messages, prompt); offset is the end of the last
+    complete line, so a line still being written is read next time.
+    """
+    offset = start
+    with open(path, "rb") as f:
+        f.seek(start)
+        for raw in f:
+            if not raw.endswith(b"\n"):
+                break
+            offset += len(raw)
+            if b'"type":"user"' not in raw and b'"type":"assistant"' not in raw:
+                continue
+            try:
+                record = json.loads(raw)
+            except ValueError:
+                continue
+            kind = record.get("type")
+            if kind not in ("user", "assistant"):
+                continue
+            messages += 1
+            if not prompt and kind == "user":
+                prompt = " ".join(prompt_text(record).split())[:PROMPT_MAX]
+    return offset, messages, prompt
+
+
+def index_file(sessions: dict, path: str):
+    sid = os.path.basename(path)[:-len(".jsonl")]
+    try:
+        st = os.stat(path)
+    except FileNotFoundError:
+        sessions.pop(sid, None)
+        return
+    old = sessions.get(sid)
+    if old and old["mtime"] == round(st.st_mtime, 3) and old["size"] == st.st_size:
+        return
+
+    # Transcripts are append-only: a grown file only needs its new tail
+    if old and st.st_size > old["size"]:
+        offset, messages, prompt = scan(path, old["offset"], old["messages"], old["prompt"])
+    else:
+        offset, messages, prompt = scan(path, 0, 0, "")
+    sessions[sid] = {
+        "id": sid,
+        "project": os.path.basename(os.path.dirname(path)),
+        "mtime": round(st.st_mtime, 3),
+        "size": st.st_size,
+        "offset": offset,
+        "messages": messages,
+        "prompt": prompt,
+    }
+
+
+def rescan(sessions: dict, projects=None):
+    """Re-index every session (of the given project dirs), drop vanished ones."""
+    dirs = projects or [os.path.basename(d) for d in glob.glob(os.path.join(PROJECTS_DIR, "*"))]
+    seen = set()
+    for project in dirs:
+        for path in glob.glob(os.path.join(PROJECTS_DIR, project, "*.jsonl")):
+            seen.add(os.path.basename(path)[:-len(".jsonl")])
+            index_file(sessions, path)
+    for sid in [sid for sid, s in sessions.items() if s["project"] in dirs and sid not in seen]:
+        del sessions[sid]
+
+
+# ─────────────────────────────────────────────────────────────
+# Lookups
+# ─────────────────────────────────────────────────────────────
+
+def matches(sessions: dict, partial: str) -> list:
+    ids = sorted(sessions)
+    i = bisect.bisect_left(ids, partial)
+    found = []
+    while i < len(ids) and ids[i].startswith(partial):
+        found.append(ids[i])
+        i += 1
+    if not found:
+        found = [sid for sid in ids if partial in sid]
+    return sorted((sessions[sid] for sid in found), key=lambda s: -s["mtime"])
+
+
+def stale_projects(project=None) -> list:
+    """Project dirs changed (session added/removed) since the index was written."""
+    try:
+        built = os.stat(INDEX).st_mtime
+    except FileNotFoundError:
+        return None
+    dirs = [os.path.join(PROJECTS_DIR, project)] if project else glob.glob(os.path.join(PROJECTS_DIR, "*"))
+    return [os.path.basename(d) for d in dirs if os.path.isdir(d) and os.stat(d).st_mtime > built]
+
+
+def fresh(project=None) -> dict:
+    stale = stale_projects(project)
+    if stale is None:
+        return locked(rescan)
+    if stale:
+        return locked(lambda s: rescan(s, stale))
+    return load()
+
+
+def cmd_find(partial: str):
+    sessions = fresh()
+    found = matches(sessions, partial)
+    if not found:
+        # Index may lag behind a session that is still running
+        found = matches(locked(rescan), partial)
+    for s in found:
+        date = time.strftime("%Y-%m-%d %H:%M", time.localtime(s["mtime"]))
+        print(f"{s['id']}\t{session_path(s)}\t{date}\t{s['size'] / 1024:.0f}k")
+
+
+def cmd_list(args: list):
+    project, limit = None, 10
+    while args:
+        if args[0] in ("-p", "--project") and len(args) > 1:
+            project, args = args[1], args[2:]
+        else:
+            limit, args = int(args[0]), args[1:]
+    sessions = fresh(project)
+    rows = [s for s in sessions.values() if project is None or s["project"] == project]
+    rows.sort(key=lambda s: -s["mtime"])
+    for s in rows[:limit]:
+        date = time.strftime("%m-%d %H:%M", time.localtime(s["mtime"]))
+        print(f"{s['id']}\t{date}\t{s['prompt']}")
+
+
+def main():
+    args = sys.argv[1:]
+    cmd = args[0] if args else ""
+    if cmd == "build":
+        sessions = locked(lambda s: (s.clear(), rescan(s)))
+        print(f"Indexed {len(sessions)} sessions")
+    elif cmd == "update":
+        if len(args) > 1:
+            locked(lambda s: [index_file(s, p) for p in args[1:] if p.endswith(".jsonl")])
+        else:
+            locked(rescan)
+    elif cmd == "find" and len(args) == 2:
+        cmd_find(args[1])
+    elif cmd == "list":
+        cmd_list(args[1:])
+    else:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,308 @@
+#!/usr/bin/env python3
+"""
+transcript - Streaming reader for Claude session transcripts (.jsonl).
+
+Memory-maps the transcript instead of reading it, so a tail of a 500MB
+session touches only its last pages:
+
+    tail     walks lines backwards from the end and decodes only the
+             user/assistant records it returns
+    range    seeks through a sparse line-offset index (every STRIDE-th
+             line start) cached in $ZENIX_CACHE/transcripts/; a grown
+             transcript extends the index from where it stopped
+    stats    scans the raw bytes with regexes (no JSON decoding) for
+             token usage, tool calls and message counts; totals are
+             cached with their offset, so only new lines are scanned
+
+Usage:
+    transcript.py tail <jsonl> [n] [--raw]          Last n turns (default 10)
+    transcript.py range <jsonl> <start> [end]       Raw lines start..end (1-based)
+    transcript.py stats <jsonl> [--json|--line]     Tokens, tool calls, messages
+
+Python callers:
+    sys.path.insert(0, "$ZENIX_ROOT/skills/system/agent/scripts")
+    import transcript
+    transcript.stats(path)
+"""
+
+import json
+import mmap
+import os
+import re
+import sys
+
+CACHE_DIR = os.path.join(
+    os.environ.get("ZENIX_CACHE", os.path.expanduser("~/.cache/zenix")), "transcripts")
+STRIDE = 1024
+TEXT_MAX = 300
+
+USAGE_RE = re.compile(
+    rb'"(input_tokens|output_tokens|cache_read_input_tokens|cache_creation_input_tokens)":(\d+)')
+TOOL_RE = re.compile(rb'"type":"tool_use"[^{}]*?"name":"([^"]+)"')
+MSG_ID_RE = re.compile(rb'"message":\{[^{}]*?"id":"([^"]+)"')
+TYPE_RE = re.compile(rb'"type":"(user|assistant)"')
+TOOL_RESULT = b'"type":"tool_result"'
+
+
+def open_map(path: str):
+    """Read-only map of the transcript (None while it is still empty)."""
+    with open(path, "rb") as f:
+        if os.fstat(f.fileno()).st_size == 0:
+            return None
+        return mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+
+# ─────────────────────────────────────────────────────────────
+# Sparse line index
+# ─────────────────────────────────────────────────────────────
+
+def _index_path(path: str) -> str:
+    real = os.path.realpath(path)
+    return os.path.join(CACHE_DIR, re.sub(r"[^A-Za-z0-9]", "_", real) + ".idx")
+
+
+def line_index(path: str, mm) -> dict:
+    """{"size", "lines", "offsets"}: offsets[k] is where line k*STRIDE starts."""
+    idx_path = _index_path(path)
+    try:
+        with open(idx_path) as f:
+            idx = json.load(f)
+    except (OSError, ValueError):
+        idx = None
+    size = len(mm)
+    if idx and idx.get("stride") == STRIDE and idx["size"] == size:
+        return idx
+    # Append-only: extend from the last complete line, else start over
+    if not idx or idx.get("stride") != STRIDE or idx["size"] > size:
+        idx = {"stride": STRIDE, "size": 0, "lines": 0, "offsets": []}
+
+    pos, lines, offsets = idx["size"], idx["lines"], idx["offsets"]
+    while pos < size:
+        end = mm.find(b"\n", pos)
+        if end < 0:
+            break  # line still being written
+        if lines % STRIDE == 0:
+            offsets.append(pos)
+        lines += 1
+        pos = end + 1
+    idx.update(size=pos, lines=lines)
+
+    os.makedirs(CACHE_DIR, exist_ok=True)
+    tmp = f"{idx_path}.{os.getpid()}.tmp"
+    with open(tmp, "w") as f:
+        json.dump(idx, f)
+    os.replace(tmp, idx_path)
+    return idx
+
+
+def lines_between(path: str, start: int, end: int):
+    """Yield raw lines start..end (1-based, inclusive)."""
+    mm = open_map(path)
+    if mm is None:
+        return
+    idx = line_index(path, mm)
+    end = min(end, idx["lines"])
+    if start < 1 or start > end:
+        return
+    block = (start - 1) // STRIDE
+    pos, line = idx["offsets"][block], block * STRIDE + 1
+    while line <= end:
+        nl = mm.find(b"\n", pos)
+        if line >= start:
+            yield mm[pos:nl]
+        pos, line = nl + 1, line + 1
+
+
+# ─────────────────────────────────────────────────────────────
+# Turns
+# ─────────────────────────────────────────────────────────────
+
+def render(record: dict) -> str:
+    """One-line text for a user/assistant record ("" for pure tool results)."""
+    role = record.get("type")
+    content = (record.get("message") or {}).get("content")
+    if isinstance(content, str):
+        parts = [content]
+    else:
+        parts = []
+        for part in content or []:
+            if not isinstance(part, dict):
+                continue
+            if part.get("type") == "text":
+                parts.append(part.get("text") or "")
+            elif part.get("type") == "tool_use":
+                parts.append(f"[{part.get('name', 'tool')}]")
+    text = " ".join(" ".join(parts).split())
+    if not text:
+        return ""
+    if len(text) > TEXT_MAX:
+        text = text[:TEXT_MAX] + "..."
+    return f"{role}: {text}"
+
+
+def tail(path: str, n: int, raw: bool = False) -> list:
+    """Last n user/assistant turns, oldest first, read backwards from the end."""
+    mm = open_map(path)
+    if mm is None:
+        return []
+    out = []
+    end = len(mm)
+    if mm[end - 1:end] != b"\n":
+        end = mm.rfind(b"\n", 0, end) + 1  # skip a line still being written
+    while end > 0 and len(out) < n:
+        start = mm.rfind(b"\n", 0, end - 1) + 1
+        line = mm[start:end - 1]
+        end = start
+        if not TYPE_RE.search(line):
+            continue
+        try:
+            record = json.loads(line)
+        except ValueError:
+            continue
+        if record.get("type") not in ("user", "assistant"):
+            continue
+        shown = line.decode("utf-8", "replace") if raw else render(record)
+        if shown:
+            out.append(shown)
+    out.reverse()
+    return out
+
+
+# ─────────────────────────────────────────────────────────────
+# Stats
+# ─────────────────────────────────────────────────────────────
+
+def _empty_stats() -> dict:
+    return {
+        "lines": 0, "user": 0, "assistant": 0, "tool_results": 0,
+        "tokens": {"input_tokens": 0, "output_tokens": 0,
+                   "cache_read_input_tokens": 0, "cache_creation_input_tokens": 0},
+        "tools": {},
+    }
+
+
+def stats(path: str) -> dict:
+    """Token totals, tool calls and message counts from the raw bytes.
+
+    The running totals are cached with the offset they cover, so a grown
+    transcript is only scanned from there.
+    """
+    mm = open_map(path)
+    if mm is None:
+        return _empty_stats()
+    cache_path = _index_path(path)[:-len(".idx")] + ".stats"
+    try:
+        with open(cache_path) as f:
+            state = json.load(f)
+    except (OSError, ValueError):
+        state = None
+    if not state or state["offset"] > len(mm):
+        state = {"offset": 0, "stats": _empty_stats(), "last_id": None, "last_usage": {}}
+
+    result, tools = state["stats"], state["stats"]["tools"]
+    # A streamed assistant message spans several lines repeating its usage:
+    # count each message id's usage once (from its last line)
+    last_id, last_usage = state["last_id"], state["last_usage"]
+
+    pos, size = state["offset"], len(mm)
+    while pos < size:
+        end = mm.find(b"\n", pos)
+        if end < 0:
+            break  # line still being written
+        line = mm[pos:end]
+        pos = end + 1
+        result["lines"] += 1
+
+        m = TYPE_RE.search(line)
+        if not m:
+            continue
+        if m.group(1) == b"user":
+            if TOOL_RESULT in line:
+                result["tool_results"] += 1
+            else:
+                result["user"] += 1
+            continue
+
+        for name in TOOL_RE.findall(line):
+            name = name.decode("utf-8", "replace")
+            tools[name] = tools.get(name, 0) + 1
+        msg = MSG_ID_RE.search(line)
+        msg_id = msg.group(1).decode() if msg else None
+        if msg_id is None or msg_id != last_id:
+            for key, value in last_usage.items():
+                result["tokens"][key] += value
+            result["assistant"] += 1
+            last_id = msg_id
+        last_usage = {k.decode(): int(v) for k, v in USAGE_RE.findall(line)}
+
+    if pos != state["offset"]:
+        state.update(offset=pos, last_id=last_id, last_usage=last_usage)
+        os.makedirs(CACHE_DIR, exist_ok=True)
+        tmp = f"{cache_path}.{os.getpid()}.tmp"
+        with open(tmp, "w") as f:
+            json.dump(state, f)
+        os.replace(tmp, cache_path)
+
+    # The last message's usage is still pending in the state
+    out = json.loads(json.dumps(result))
+    for key, value in last_usage.items():
+        out["tokens"][key] += value
+    return out
+
+
+def summary_line(s: dict) -> str:
+    """e.g. "12 prompts, 40 replies, 85 tool calls, 1.2M tokens" """
+    t = s["tokens"]
+    total = sum(t.values())
+    if total >= 1_000_000:
+        tokens = f"{total / 1_000_000:.1f}M"
+    elif total >= 1000:
+        tokens = f"{total / 1000:.0f}k"
+    else:
+        tokens = str(total)
+    calls = sum(s["tools"].values())
+    return f"{s['user']} prompts, {s['assistant']} replies, {calls} tool calls, {tokens} tokens"
+
+
+def print_stats(s: dict):
+    t = s["tokens"]
+    print(f"messages  {s['user']} user, {s['assistant']} assistant, {s['tool_results']} tool results")
+    print(f"tokens    {t['input_tokens']} in, {t['output_tokens']} out, "
+          f"{t['cache_read_input_tokens']} cache read, {t['cache_creation_input_tokens']} cache write")
+    calls = sum(s["tools"].values())
+    top = ", ".join(f"{name} {n}" for name, n in sorted(s["tools"].items(), key=lambda kv: -kv[1]))
+    print(f"tools     {calls} calls" + (f" ({top})" if top else ""))
+
+
+def main():
+    args = [a for a in sys.argv[1:] if not a.startswith("--")]
+    flags = {a for a in sys.argv[1:] if a.startswith("--")}
+    try:
+        if len(args) >= 2 and args[0] == "tail":
+            n = int(args[2]) if len(args) > 2 else 10
+            for line in tail(args[1], n, raw="--raw" in flags):
+                print(line)
+        elif len(args) >= 3 and args[0] == "range":
+            start = int(args[2])
+            end = int(args[3]) if len(args) > 3 else start
+            out = sys.stdout.buffer
+            for line in lines_between(args[1], start, end):
+                out.write(line + b"\n")
+        elif len(args) == 2 and args[0] == "stats":
+            s = stats(args[1])
+            if "--json" in flags:
+                print(json.dumps(s))
+            elif "--line" in flags:
+                print(summary_line(s))
+            else:
+                print_stats(s)
+        else:
+            print(__doc__.strip(), file=sys.stderr)
+            sys.exit(1)
+    except FileNotFoundError as e:
+        print(f"Transcript not found: {e.filename}", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
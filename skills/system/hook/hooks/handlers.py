@@ -0,0 +1,70 @@
+"""In-process hook handlers (served by scripts/hookd.py, see persist-env.sh)."""
+
+import glob
+import os
+import shlex
+import subprocess
+
+CACHE_DIR = os.environ.get("ZENIX_CACHE", os.path.expanduser("~/.cache/zenix"))
+
+
+def env_header(path):
+    """(@always?, [@depends paths]) from an env file's leading comments."""
+    always, depends = False, []
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if line.startswith("# @always"):
+                always = True
+            elif line.startswith("# @depends "):
+                dep = line[len("# @depends "):]
+                depends.append(dep if dep.startswith("/") else os.path.join(os.path.dirname(path), dep))
+            elif line and not line.startswith("#"):
+                break
+    return always, depends
+
+
+def always_snapshots(root):
+    """(snapshot, env) of every @always skill env; stale snapshots are
+    recompiled by zenix/lib/env.sh (same rules as its guard line)."""
+    pairs = []
+    for env in sorted(glob.glob(os.path.join(root, "skills", "*", "*", "env"))):
+        always, depends = env_header(env)
+        if not always:
+            continue
+        name = os.path.relpath(os.path.dirname(env), os.path.join(root, "skills"))
+        snap = os.path.join(CACHE_DIR, "env", name.replace(os.sep, "-") + ".sh")
+        try:
+            built = os.stat(snap).st_mtime
+            stale = any(os.path.exists(p) and os.stat(p).st_mtime > built for p in [env] + depends)
+        except OSError:
+            stale = True
+        if stale:
+            lib = os.path.join(root, "skills", "system", "zenix", "lib", "env.sh")
+            subprocess.run(["bash", "-c", 'source "$0" && env_compile "$1" "$2"', lib, env, snap],
+                           stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL,
+                           stderr=subprocess.DEVNULL)
+        pairs.append((snap, env))
+    return pairs
+
+
+def persist_env(event, ctx):
+    session_id = event.get("session_id") or ""
+    cwd = event.get("cwd") or ""
+
+    # Persist to CLAUDE_ENV_FILE (available for all subsequent Bash commands)
+    if ctx.env_file:
+        with open(ctx.env_file, "a") as f:
+            if session_id:
+                f.write(f'export CLAUDE_SESSION_ID="{session_id}"\n')
+            if cwd:
+                f.write(f'export CLAUDE_CWD="{cwd}"\n')
+            # @always skill envs as cached snapshots (plain assignments)
+            for snap, env in always_snapshots(ctx.zenix_root):
+                f.write(f"source {shlex.quote(snap)} 2>/dev/null || source {shlex.quote(env)}\n")
+
+    # Output to context (Claude sees this)
+    return f"Session: {session_id}" if session_id else None
+
+
+HANDLERS = {"persist-env": persist_env}
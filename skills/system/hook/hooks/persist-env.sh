@@ -11,6 +11,18 @@ cwd=$(echo "$input" | jq -r '.cwd // empty')
 if [ -n "$CLAUDE_ENV_FILE" ]; then
   [ -n "$session_id" ] && echo "export CLAUDE_SESSION_ID=\"$session_id\"" >> "$CLAUDE_ENV_FILE"
   [ -n "$cwd" ] && echo "export CLAUDE_CWD=\"$cwd\"" >> "$CLAUDE_ENV_FILE"
+
+  # @always skill envs: point at their cached snapshots (compiled here if
+  # stale) so each Bash command applies plain assignments, not the env files
+  if [ -n "$ZENIX_ROOT" ] && [ -f "$ZENIX_ROOT/skills/system/zenix/lib/env.sh" ]; then
+    source "$ZENIX_ROOT/skills/system/zenix/lib/env.sh"
+    for env in "$ZENIX_ROOT"/skills/*/*/env; do
+      [ -f "$env" ] && head -3 "$env" | grep -q '^# @always' || continue
+      env_snapshot snap "$env"
+      (source "$snap" >/dev/null 2>&1) || env_compile "$env" "$snap" || continue
+      printf 'source %q 2>/dev/null || source %q\n' "$snap" "$env" >> "$CLAUDE_ENV_FILE"
+    done
+  fi
 fi
 
 # Output to context (Claude sees this)
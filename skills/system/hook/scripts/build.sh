@@ -1,77 +1,63 @@
 #!/bin/bash
 # Build .claude/settings.json from skills/*/*/hooks/settings.yaml
+#
+# Per-skill fragments (scripts/fragments.py) are parsed only when their
+# yaml changed; all of them merge with the existing settings in one jq pass.
 set -e
 
 ZENIX_ROOT="${ZENIX_ROOT:-$HOME/.zenix}"
 SETTINGS_FILE="$ZENIX_ROOT/.claude/settings.json"
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
 
-# Read existing settings (preserve env, statusLine, effortLevel)
-if [ -f "$SETTINGS_FILE" ]; then
-    ENV=$(jq -c '.env // {}' "$SETTINGS_FILE")
-    STATUS_LINE=$(jq -c '.statusLine // null' "$SETTINGS_FILE")
-    EFFORT_LEVEL=$(jq -r '.effortLevel // "medium"' "$SETTINGS_FILE")
-else
-    ENV='{}'
-    STATUS_LINE='null'
-    EFFORT_LEVEL='medium'
+# A failed fragment build must not rewrite settings.json without its hooks
+if ! LIST=$(python3 "$SCRIPT_DIR/fragments.py"); then
+    echo "fragments.py failed; $SETTINGS_FILE left unchanged" >&2
+    exit 1
 fi
+FRAGMENTS=()
+while IFS= read -r fragment; do
+    [ -n "$fragment" ] && FRAGMENTS+=("$fragment")
+done <<< "$LIST"
 
-# Collect all hooks from YAML files
-ALL_HOOKS='[]'
-
-for yaml_file in "$ZENIX_ROOT"/skills/*/*/hooks/settings.yaml; do
-    [ -f "$yaml_file" ] || continue
-
-    SKILL_DIR=$(dirname "$(dirname "$yaml_file")")
-    SKILL_NAME=$(basename "$SKILL_DIR")
-    CATEGORY=$(basename "$(dirname "$SKILL_DIR")")
-    SKILL_PATH="$CATEGORY/$SKILL_NAME"
-
-    # Parse YAML to JSON
-    if command -v yq &>/dev/null; then
-        ENTRIES=$(yq -o=json '.' "$yaml_file" 2>/dev/null || echo '[]')
-    else
-        ENTRIES=$(python3 -c "
-import yaml, json
-with open('$yaml_file') as f:
-    data = yaml.safe_load(f)
-print(json.dumps(data if data else []))
-" 2>/dev/null || echo '[]')
-    fi
+# Existing settings: preserve env, statusLine, effortLevel
+CURRENT="$SETTINGS_FILE"
+[ -f "$CURRENT" ] || CURRENT=/dev/null
 
-    # Add skill path (category/name) to each entry
-    ENTRIES=$(echo "$ENTRIES" | jq --arg skill "$SKILL_PATH" '[.[] | . + {_skill: $skill}]')
-    ALL_HOOKS=$(echo "$ALL_HOOKS" "$ENTRIES" | jq -s 'add')
-done
+TMP_FILE="$SETTINGS_FILE.$$.tmp"
+trap 'rm -f "$TMP_FILE"' EXIT
 
-# Build hooks object grouped by event
-HOOKS=$(echo "$ALL_HOOKS" | jq '
+jq -n --slurpfile current "$CURRENT" '
+    ($current[0] // {}) as $cur |
+    [inputs[]] |
     group_by(.event) |
     map({
         key: .[0].event,
         value: [.[] | {
             hooks: [{
                 type: "command",
-                command: ("\"$CLAUDE_PROJECT_DIR\"/skills/" + ._skill + "/hooks/" + .script)
+                command: (
+                    (if .handler then "\"$CLAUDE_PROJECT_DIR\"/skills/system/hook/hooks/hookc "
+                        + .category + "/" + .skill + ":" + .handler + " " else "" end)
+                    + "\"$CLAUDE_PROJECT_DIR\"/skills/" + .category + "/" + .skill + "/hooks/" + .script)
             } + (if .timeout then {timeout: .timeout} else {} end)]
         } + (if .matcher then {matcher: .matcher} else {} end)]
     }) |
-    from_entries
-')
-
-# Build final settings.json
-jq -n \
-    --argjson env "$ENV" \
-    --argjson hooks "$HOOKS" \
-    --argjson statusLine "$STATUS_LINE" \
-    --arg effortLevel "$EFFORT_LEVEL" \
-    '{
+    from_entries |
+    {
         _generated: "Auto-generated by skills/hook/scripts/build.sh",
-        env: $env,
-        hooks: $hooks,
-        statusLine: $statusLine,
-        effortLevel: $effortLevel
-    } | if .statusLine == null then del(.statusLine) else . end' \
-    > "$SETTINGS_FILE"
-
-echo "Built $SETTINGS_FILE from $(echo "$ALL_HOOKS" | jq 'length') hooks"
+        env: ($cur.env // {}),
+        hooks: .,
+        statusLine: ($cur.statusLine // null),
+        effortLevel: ($cur.effortLevel // "medium")
+    } | if .statusLine == null then del(.statusLine) else . end
+' ${FRAGMENTS[@]+"${FRAGMENTS[@]}"} < /dev/null > "$TMP_FILE"
+
+COUNT=$(jq '[.hooks[][]] | length' "$TMP_FILE")
+
+# Leave settings.json (and its mtime) alone when nothing changed
+if cmp -s "$TMP_FILE" "$SETTINGS_FILE"; then
+    echo "$SETTINGS_FILE up to date ($COUNT hooks)"
+else
+    mv "$TMP_FILE" "$SETTINGS_FILE"
+    echo "Built $SETTINGS_FILE from $COUNT hooks"
+fi
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+"""
+fragments - Per-skill hook fragments shared by build.sh and list.sh.
+
+Each skills/<category>/<skill>/hooks/settings.yaml compiles to one fragment
+under $ZENIX_CACHE/hooks/:
+
+    <category>__<skill>.json   hook entries tagged with skill + category
+    <category>__<skill>.sha1   hash of the yaml the fragment came from
+
+A fragment is fresh when it is newer than its yaml; when it is not, the
+content hash decides whether to re-parse or just touch it. So a rebuild
+only parses the skills whose hooks actually changed, and callers merge
+all fragments with a single jq pass.
+
+Usage:
+    fragments.py    Refresh fragments, print their paths in skill order
+"""
+
+import glob
+import hashlib
+import json
+import os
+import sys
+
+sys.dont_write_bytecode = True
+ZENIX_ROOT = os.environ.get("ZENIX_ROOT", os.path.expanduser("~/.zenix"))
+sys.path.insert(0, os.path.join(ZENIX_ROOT, "skills/system/zenix/lib"))
+import config_cache  # noqa: E402
+
+CACHE_DIR = os.path.join(
+    os.environ.get("ZENIX_CACHE", os.path.expanduser("~/.cache/zenix")), "hooks")
+
+
+def _write(path: str, content: str):
+    tmp = f"{path}.{os.getpid()}.tmp"
+    with open(tmp, "w") as f:
+        f.write(content)
+    os.replace(tmp, path)
+
+
+def entries(data, category: str, skill: str) -> list:
+    """Hook entries of one settings.yaml, tagged with where they came from."""
+    out = []
+    for entry in data if isinstance(data, list) else []:
+        if isinstance(entry, dict) and entry.get("event") and entry.get("script"):
+            out.append(dict(entry, skill=skill, category=category))
+    return out
+
+
+def refresh(yaml_path: str) -> str:
+    """Ensure the fragment for yaml_path is fresh; return its path."""
+    skill_dir = os.path.dirname(os.path.dirname(yaml_path))
+    skill = os.path.basename(skill_dir)
+    category = os.path.basename(os.path.dirname(skill_dir))
+    base = os.path.join(CACHE_DIR, f"{category}__{skill}")
+    json_path, sha_path = base + ".json", base + ".sha1"
+
+    try:
+        if os.stat(json_path).st_mtime > os.stat(yaml_path).st_mtime:
+            return json_path
+    except FileNotFoundError:
+        pass
+
+    with open(yaml_path, "rb") as f:
+        raw = f.read()
+    digest = hashlib.sha1(raw).hexdigest()
+    try:
+        with open(sha_path) as f:
+            unchanged = f.read().strip() == digest
+    except FileNotFoundError:
+        unchanged = False
+    if unchanged and os.path.exists(json_path):
+        # Touched but not edited: keep the fragment, refresh the mtime key
+        os.utime(json_path)
+        return json_path
+
+    data = config_cache.parse(raw.decode("utf-8", "replace"))
+    _write(json_path, json.dumps(entries(data, category, skill)))
+    _write(sha_path, digest + "\n")
+    return json_path
+
+
+def main():
+    if len(sys.argv) > 1:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+    os.makedirs(CACHE_DIR, exist_ok=True)
+    live = set()
+    for yaml_path in sorted(glob.glob(os.path.join(ZENIX_ROOT, "skills/*/*/hooks/settings.yaml"))):
+        path = refresh(yaml_path)
+        live.add(path)
+        print(path)
+
+    # Drop fragments of skills that lost their hooks
+    for path in glob.glob(os.path.join(CACHE_DIR, "*.json")):
+        if path not in live:
+            for stale in (path, path[:-5] + ".sha1"):
+                try:
+                    os.remove(stale)
+                except FileNotFoundError:
+                    pass
+
+
+if __name__ == "__main__":
+    main()
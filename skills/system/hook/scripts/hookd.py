@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+"""
+hookd - Persistent hook host for in-process hook handlers.
+
+Hook entries with a `handler:` field are built into settings.json as
+
+    hooks/hookc <category/skill:handler> <script>
+
+hookc forwards the hook's stdin to this daemon over a unix socket instead
+of starting the script. The daemon parses the payload once and calls the
+handler from skills/<category>/<skill>/hooks/handlers.py:
+
+    def snapshot(event: dict, ctx) -> Optional[str] | tuple[int, str]
+    HANDLERS = {"snapshot": snapshot}
+
+ctx carries cwd, env_file (CLAUDE_ENV_FILE) and zenix_root. A str return
+is printed by hookc (exit 0); (code, text) exits with code and prints text
+to stderr. When a handler raises, hookc runs the script instead. The
+handlers.py of a skill is re-imported when its mtime changes.
+
+Protocol (one request per connection):
+    request   <handler>\\t<cwd>\\t<env_file>\\t<length>\\n<length bytes of json>
+    response  <code>\\n<output>         or     fallback\\n
+
+Usage:
+    hookd.py          Serve on $ZENIX_ROOT/data/hook/hookd.sock (foreground)
+    hookd.py stop     Stop a running host
+    hookd.py status   Print host pid, uptime and handled calls
+
+Exits on its own after $HOOKD_IDLE seconds without calls (default 3600);
+the next hookc call starts it again.
+"""
+
+import fcntl
+import importlib.util
+import json
+import os
+import signal
+import socket
+import socketserver
+import sys
+import threading
+import time
+import traceback
+from datetime import datetime
+from types import SimpleNamespace
+
+sys.dont_write_bytecode = True  # keep __pycache__ out of skills/*/hooks
+
+ZENIX_ROOT = os.environ.get("ZENIX_ROOT", os.path.expanduser("~/.zenix"))
+DATA_DIR = os.path.join(ZENIX_ROOT, "data", "hook")
+SOCKET_PATH = os.path.join(DATA_DIR, "hookd.sock")
+PID_FILE = os.path.join(DATA_DIR, "hookd.pid")
+STATS_FILE = os.path.join(DATA_DIR, "hookd.stats")
+IDLE_TIMEOUT = float(os.environ.get("HOOKD_IDLE", "3600"))
+MAX_HEADER = 8192
+
+
+def log(msg: str):
+    """Daemon-level log line (stdout is redirected to hookd.log)."""
+    print(f"{datetime.now():%H:%M:%S} [hookd] {msg}", flush=True)
+
+
+# ─────────────────────────────────────────────────────────────
+# Handler modules
+# ─────────────────────────────────────────────────────────────
+
+class Handlers:
+    """skills/<category>/<skill>/hooks/handlers.py, imported on first use."""
+
+    def __init__(self):
+        self.modules = {}  # skill -> (mtime, HANDLERS)
+        self.lock = threading.Lock()
+
+    def get(self, handler_id: str):
+        skill, _, name = handler_id.partition(":")
+        if skill.count("/") != 1 or ".." in skill or not name:
+            raise KeyError(f"bad handler id: {handler_id}")
+        path = os.path.join(ZENIX_ROOT, "skills", skill, "hooks", "handlers.py")
+        mtime = os.stat(path).st_mtime
+
+        with self.lock:
+            cached = self.modules.get(skill)
+            if cached is None or cached[0] != mtime:
+                spec = importlib.util.spec_from_file_location(
+                    "hookd_" + skill.replace("/", "_").replace("-", "_"), path)
+                module = importlib.util.module_from_spec(spec)
+                spec.loader.exec_module(module)
+                cached = (mtime, getattr(module, "HANDLERS", {}))
+                self.modules[skill] = cached
+                log(f"loaded {skill} ({', '.join(sorted(cached[1])) or 'no handlers'})")
+        return cached[1][name]
+
+
+# ─────────────────────────────────────────────────────────────
+# Server
+# ─────────────────────────────────────────────────────────────
+
+def read_request(sock: socket.socket) -> tuple:
+    buf = b""
+    while b"\n" not in buf:
+        chunk = sock.recv(4096)
+        if not chunk or len(buf) > MAX_HEADER:
+            raise ValueError("truncated header")
+        buf += chunk
+    header, _, body = buf.partition(b"\n")
+    handler_id, cwd, env_file, length = header.decode().split("\t")
+    length = int(length)
+    while len(body) < length:
+        chunk = sock.recv(min(65536, length - len(body)))
+        if not chunk:
+            raise ValueError("truncated body")
+        body += chunk
+    return handler_id, cwd, env_file, body[:length]
+
+
+class Request(socketserver.BaseRequestHandler):
+    def handle(self):
+        server = self.server
+        server.touch()
+        try:
+            handler_id, cwd, env_file, body = read_request(self.request)
+        except (ValueError, UnicodeDecodeError) as e:
+            log(f"bad request: {e}")
+            self.request.sendall(b"fallback\n")
+            return
+
+        try:
+            event = json.loads(body) if body.strip() else {}
+            ctx = SimpleNamespace(cwd=cwd, env_file=env_file, zenix_root=ZENIX_ROOT)
+            result = server.handlers.get(handler_id)(event, ctx)
+        except Exception:
+            log(f"{handler_id} failed, falling back to script:\n{traceback.format_exc().rstrip()}")
+            server.count(handler_id, failed=True)
+            self.request.sendall(b"fallback\n")
+            return
+
+        code, output = result if isinstance(result, tuple) else (0, result)
+        server.count(handler_id)
+        self.request.sendall(f"{int(code)}\n{output or ''}".encode())
+
+
+class HookServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    daemon_threads = True
+
+    def __init__(self):
+        super().__init__(SOCKET_PATH, Request)
+        os.chmod(SOCKET_PATH, 0o600)
+        self.handlers = Handlers()
+        self.last_call = time.time()
+        self.calls = {}  # handler id -> [ok, failed]
+        self.stats_lock = threading.Lock()
+
+    def touch(self):
+        self.last_call = time.time()
+
+    def count(self, handler_id: str, failed: bool = False):
+        with self.stats_lock:
+            counts = self.calls.setdefault(handler_id, [0, 0])
+            counts[1 if failed else 0] += 1
+            lines = [f"{h}\t{ok}\t{bad}" for h, (ok, bad) in sorted(self.calls.items())]
+        tmp = f"{STATS_FILE}.tmp"
+        with open(tmp, "w") as f:
+            f.write("\n".join(lines) + "\n")
+        os.replace(tmp, STATS_FILE)
+
+    def watch_idle(self):
+        while True:
+            time.sleep(min(60.0, IDLE_TIMEOUT))
+            if time.time() - self.last_call >= IDLE_TIMEOUT:
+                log(f"idle for {IDLE_TIMEOUT:g}s, exiting")
+                self.shutdown()
+                return
+
+
+def socket_alive() -> bool:
+    s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    try:
+        s.connect(SOCKET_PATH)
+        return True
+    except OSError:
+        return False
+    finally:
+        s.close()
+
+
+def read_pid() -> int:
+    try:
+        with open(PID_FILE) as f:
+            pid = int(f.read().strip())
+        os.kill(pid, 0)
+        return pid
+    except (OSError, ValueError):
+        return 0
+
+
+def serve():
+    os.makedirs(DATA_DIR, exist_ok=True)
+    # hookc may start several hosts at once; one wins the lock
+    lock = os.open(os.path.join(DATA_DIR, "hookd.lock"), os.O_RDWR | os.O_CREAT, 0o644)
+    try:
+        fcntl.flock(lock, fcntl.LOCK_EX | fcntl.LOCK_NB)
+    except BlockingIOError:
+        sys.exit(0)
+    if socket_alive():
+        sys.exit(0)
+    try:
+        os.unlink(SOCKET_PATH)
+    except FileNotFoundError:
+        pass
+
+    server = HookServer()
+    with open(PID_FILE, "w") as f:
+        f.write(f"{os.getpid()}\n")
+
+    def stop(_signum, _frame):
+        threading.Thread(target=server.shutdown, daemon=True).start()
+
+    signal.signal(signal.SIGTERM, stop)
+    signal.signal(signal.SIGINT, stop)
+    threading.Thread(target=server.watch_idle, daemon=True).start()
+    log(f"started (pid {os.getpid()}, root {ZENIX_ROOT})")
+    try:
+        server.serve_forever()
+    finally:
+        server.server_close()
+        for path in (SOCKET_PATH, PID_FILE, STATS_FILE):
+            try:
+                os.unlink(path)
+            except FileNotFoundError:
+                pass
+        log("stopped")
+
+
+def cmd_stop():
+    pid = read_pid()
+    if not pid:
+        print("hookd is not running")
+        return
+    os.kill(pid, signal.SIGTERM)
+    print(f"Stopped hookd (PID {pid})")
+
+
+def cmd_status():
+    pid = read_pid()
+    if not pid:
+        print("hookd: stopped (starts on the next handler hook)")
+        return
+    uptime = int(time.time() - os.stat(PID_FILE).st_mtime)
+    print(f"hookd: PID {pid}, up {uptime // 60}m, socket {SOCKET_PATH}")
+    try:
+        with open(STATS_FILE) as f:
+            for line in f:
+                handler_id, ok, failed = line.rstrip("\n").split("\t")
+                extra = f", {failed} fell back" if failed != "0" else ""
+                print(f"  {handler_id}: {ok} calls{extra}")
+    except FileNotFoundError:
+        pass
+
+
+def main():
+    cmd = sys.argv[1] if len(sys.argv) > 1 else "serve"
+    if cmd == "serve":
+        serve()
+    elif cmd == "stop":
+        cmd_stop()
+    elif cmd == "status":
+        cmd_status()
+    else:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
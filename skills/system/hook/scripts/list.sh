@@ -41,33 +41,15 @@ while [[ $# -gt 0 ]]; do
     esac
 done
 
-# Collect all hooks
+# Collect all hooks from the per-skill fragment cache (shared with build.sh)
 collect_hooks() {
-    for yaml_file in "$ZENIX_ROOT"/skills/*/*/hooks/settings.yaml; do
-        [ -f "$yaml_file" ] || continue
-
-        SKILL_DIR=$(dirname "$(dirname "$yaml_file")")
-        SKILL_NAME=$(basename "$SKILL_DIR")
-        CATEGORY=$(basename "$(dirname "$SKILL_DIR")")
-
-        # Parse YAML
-        if command -v yq &>/dev/null; then
-            yq -o=json '.' "$yaml_file" 2>/dev/null | jq -c \
-                --arg skill "$SKILL_NAME" \
-                --arg category "$CATEGORY" \
-                '.[] | . + {skill: $skill, category: $category}'
-        else
-            python3 -c "
-import yaml, json, sys
-with open('$yaml_file') as f:
-    data = yaml.safe_load(f) or []
-for entry in data:
-    entry['skill'] = '$SKILL_NAME'
-    entry['category'] = '$CATEGORY'
-    print(json.dumps(entry))
-" 2>/dev/null || true
-        fi
-    done
+    local fragments=()
+    while IFS= read -r fragment; do
+        fragments+=("$fragment")
+    done < <(python3 "$ZENIX_ROOT/skills/system/hook/scripts/fragments.py")
+    [ ${#fragments[@]} -gt 0 ] || return 0
+
+    jq -c '.[]' "${fragments[@]}"
 }
 
 # Filter hooks
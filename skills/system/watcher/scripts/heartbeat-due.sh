@@ -0,0 +1,12 @@
+#!/bin/bash
+# Heartbeat precheck: succeed only when vault/Heartbeat.md has something to
+# evaluate, so the cron job does not start the agent just to answer
+# HEARTBEAT_OK (see agents/heartbeat.md).
+#
+# Lines that never need action: blank, headings, comments, done items.
+
+ZENIX_ROOT="${ZENIX_ROOT:-$HOME/.zenix}"
+CHECKLIST="$ZENIX_ROOT/vault/Heartbeat.md"
+
+[[ -f "$CHECKLIST" ]] || exit 1
+grep -qvE '^[[:space:]]*($|#|<!--|[-*] \[[xX]\])' "$CHECKLIST"
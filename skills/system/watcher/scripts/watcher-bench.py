@@ -0,0 +1,358 @@
+#!/usr/bin/env python3
+"""
+watcher-bench - Throughput and latency benchmark for watcherd.
+
+Runs a private watcherd against a synthetic vault, with the real
+vault-files/vault-notes watcher yamls (debounce shortened, actions
+replaced by a stub that records when it started). Events are replayed
+through a stub `fswatch` on PATH that reads from a FIFO, so the daemon
+takes its normal fswatch code path and the run does not depend on the
+host's file notification timing.
+
+The synthetic vault mixes what iCloud delivers in a sync burst: root
+notes (both watchers fire), Tasks/ notes (condition fork, some submit),
+index.md and Files/ attachments (matched by nothing), .obsidian noise
+(excluded). Every file can be replayed several times to exercise the
+debounce coalescing.
+
+Reported:
+    latency      last event of a path → its action starting (p50/p99),
+                 debounce included
+    events/s     events replayed / seconds until the daemon drained them
+    forks/event  children forked by the daemon per event (stats file)
+    cpu/event    daemon user+sys CPU per event
+    rss          daemon peak RSS
+    dropped      expected actions that never ran
+    duplicated   actions that ran more than once for the same path
+
+Usage:
+    watcher-bench.py [options]
+        --files N       Files in the burst (default 5000)
+        --updates N     Events per file (default 1)
+        --rate N        Events per second, 0 = as fast as possible (default 0)
+        --debounce S    Debounce for the watchers (default 0.5)
+        --timeout S     Give up waiting for actions after S idle seconds (default 30)
+        --json          Print the result as JSON
+        --baseline F    Compare with a previous --json result
+"""
+
+import json
+import os
+import random
+import re
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+import time
+
+sys.dont_write_bytecode = True
+
+ZENIX_ROOT = os.environ.get("ZENIX_ROOT", os.path.expanduser("~/.zenix"))
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DAEMON = os.path.join(SCRIPT_DIR, "watcherd.py")
+VAULT_WATCHERS = os.path.join(ZENIX_ROOT, "skills", "core", "vault", "watchers")
+YAMLS = ("files.yaml", "vault-notes.yaml")
+
+STUB_FSWATCH = """#!/bin/sh
+exec cat "$BENCH_FIFO"
+"""
+
+# Appends "<start time> <watcher> <path>"; EPOCHREALTIME needs bash 5
+STUB_ACTION = """#!/bin/bash
+if [[ -n "${EPOCHREALTIME:-}" ]]; then
+    t=$EPOCHREALTIME
+else
+    t=$(perl -MTime::HiRes=time -e 'printf "%.6f", time')
+fi
+w=$1
+shift
+for p in "$@"; do echo "$t $w $p"; done >> "$BENCH_ACTIONS"
+"""
+
+METRICS = (
+    # key, label, unit, lower is better
+    ("p50_ms", "latency p50", "ms", True),
+    ("p99_ms", "latency p99", "ms", True),
+    ("events_per_sec", "events/s", "", False),
+    ("forks_per_event", "forks/event", "", True),
+    ("cpu_ms_per_event", "cpu/event", "ms", True),
+    ("rss_kb", "rss", "kB", True),
+    ("dropped", "dropped", "", True),
+    ("duplicated", "duplicated", "", True),
+)
+
+
+def parse_args(argv: list) -> dict:
+    opts = {"files": 5000, "updates": 1, "rate": 0.0, "debounce": 0.5,
+            "timeout": 30.0, "json": False, "baseline": None}
+    numeric = {"--files": int, "--updates": int, "--rate": float,
+               "--debounce": float, "--timeout": float}
+    while argv:
+        arg = argv.pop(0)
+        if arg in numeric and argv:
+            opts[arg[2:]] = numeric[arg](argv.pop(0))
+        elif arg == "--baseline" and argv:
+            opts["baseline"] = argv.pop(0)
+        elif arg == "--json":
+            opts["json"] = True
+        else:
+            print(__doc__.strip(), file=sys.stderr)
+            sys.exit(1)
+    return opts
+
+
+def percentile(values: list, p: float) -> float:
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(round(p / 100 * (len(values) - 1))))]
+
+
+# ─────────────────────────────────────────────────────────────
+# Sandbox
+# ─────────────────────────────────────────────────────────────
+
+def write_exec(path: str, text: str):
+    with open(path, "w") as f:
+        f.write(text)
+    os.chmod(path, 0o755)
+
+
+def setup(base: str, debounce: float) -> dict:
+    """Private ZENIX_ROOT with the vault watchers pointed at the stub action."""
+    root = os.path.join(base, "root")
+    watchers_dir = os.path.join(root, "skills", "core", "vault", "watchers")
+    os.makedirs(watchers_dir)
+    bin_dir = os.path.join(base, "bin")
+    os.makedirs(bin_dir)
+    write_exec(os.path.join(bin_dir, "fswatch"), STUB_FSWATCH)
+    write_exec(os.path.join(root, "bench-action.sh"), STUB_ACTION)
+
+    names = []
+    for name in YAMLS:
+        with open(os.path.join(VAULT_WATCHERS, name)) as f:
+            text = f.read()
+        watcher = re.search(r"^name:\s*(\S+)", text, re.M).group(1)
+        names.append(watcher)
+        text = re.sub(r"^debounce:.*$", f"debounce: {debounce:g}", text, flags=re.M)
+        text = re.sub(r"^(\s*)action:.*$", rf"\1action: bench-action.sh {watcher}", text, flags=re.M)
+        with open(os.path.join(watchers_dir, name), "w") as f:
+            f.write(text)
+
+    vault = os.path.join(root, "vault")
+    for sub in ("Tasks", "Files", ".obsidian"):
+        os.makedirs(os.path.join(vault, sub))
+    return {
+        "root": root,
+        "vault": os.path.realpath(vault),  # watcherd matches against real paths
+        "bin": bin_dir,
+        "state": os.path.join(base, "state"),
+        "fifo": os.path.join(base, "events"),
+        "actions": os.path.join(base, "actions"),
+        "watchers": names,
+    }
+
+
+def synthetic_files(vault: str, n: int) -> list:
+    """[(path, watchers expected to fire)]: the mix of a sync burst."""
+    rng = random.Random(42)
+    files = []
+    for i in range(n):
+        roll = rng.random()
+        if roll < 0.60:
+            files.append((f"{vault}/Note {i:05d}.md", "note"))
+        elif roll < 0.75:
+            submit = rng.random() < 0.5
+            files.append((f"{vault}/Tasks/task-{i:05d}.md", "submit" if submit else "task"))
+        elif roll < 0.90:
+            files.append((f"{vault}/Files/attachment-{i:05d}.png", "none"))
+        else:
+            files.append((f"{vault}/.obsidian/workspace-{i:05d}.json", "none"))
+    if n:
+        files[0] = (f"{vault}/index.md", "none")
+    for path, kind in files:
+        with open(path, "w") as f:
+            f.write("---\nsubmit: true\n---\n" if kind == "submit" else "# note\n")
+    return files
+
+
+# ─────────────────────────────────────────────────────────────
+# Daemon probes
+# ─────────────────────────────────────────────────────────────
+
+def read_stats(pid: int, state: str) -> dict:
+    """Ask the daemon for its counters (SIGUSR1 → stats file)."""
+    path = os.path.join(state, "stats")
+    try:
+        os.remove(path)
+    except FileNotFoundError:
+        pass
+    os.kill(pid, signal.SIGUSR1)
+    deadline = time.monotonic() + 5
+    while time.monotonic() < deadline:
+        try:
+            with open(path) as f:
+                return {k: int(v) for k, v in (line.split() for line in f)}
+        except (FileNotFoundError, ValueError):
+            time.sleep(0.02)
+    return {}
+
+
+def proc_usage(pid: int) -> tuple:
+    """(cpu seconds, peak rss kB) of the daemon."""
+    try:
+        with open(f"/proc/{pid}/stat") as f:
+            fields = f.read().rsplit(")", 1)[1].split()
+        cpu = (int(fields[11]) + int(fields[12])) / os.sysconf("SC_CLK_TCK")
+        with open(f"/proc/{pid}/status") as f:
+            hwm = next(line for line in f if line.startswith("VmHWM:"))
+        return cpu, int(hwm.split()[1])
+    except (OSError, StopIteration):
+        pass
+    # macOS: no /proc, current RSS stands in for the peak
+    out = subprocess.run(["ps", "-o", "rss=,time=", "-p", str(pid)],
+                         capture_output=True, text=True).stdout.split()
+    if len(out) < 2:
+        return 0.0, 0
+    cpu = 0.0
+    for part in out[1].split(":"):
+        cpu = cpu * 60 + float(part)
+    return cpu, int(out[0])
+
+
+# ─────────────────────────────────────────────────────────────
+# Run
+# ─────────────────────────────────────────────────────────────
+
+def read_actions(path: str) -> list:
+    try:
+        with open(path) as f:
+            return [line.rstrip("\n").split(" ", 2) for line in f if line.count(" ") >= 2]
+    except FileNotFoundError:
+        return []
+
+
+def bench(opts: dict) -> dict:
+    base = tempfile.mkdtemp(prefix="watcher-bench.")
+    daemon = None
+    try:
+        env_paths = setup(base, opts["debounce"])
+        files = synthetic_files(env_paths["vault"], opts["files"])
+        os.mkfifo(env_paths["fifo"])
+        env = dict(os.environ,
+                   ZENIX_ROOT=env_paths["root"],
+                   ZENIX_CACHE=os.path.join(base, "cache"),
+                   WATCHER_STATE_DIR=env_paths["state"],
+                   ZENIX_METRICS_DIR=os.path.join(base, "metrics"),
+                   PATH=env_paths["bin"] + os.pathsep + os.environ.get("PATH", ""),
+                   BENCH_FIFO=env_paths["fifo"],
+                   BENCH_ACTIONS=env_paths["actions"])
+        daemon = subprocess.Popen([sys.executable, DAEMON], env=env, stdin=subprocess.DEVNULL,
+                                  stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        # Opening the write end waits for the stub fswatch, i.e. a loaded daemon
+        fifo = open(env_paths["fifo"], "wb", buffering=0)
+        cpu0, _ = proc_usage(daemon.pid)
+        forks0 = read_stats(daemon.pid, env_paths["state"]).get("forks", 0)
+
+        # Replay: every file, `updates` rounds, fswatch -0 -x records
+        last_event = {}
+        interval = 1.0 / opts["rate"] if opts["rate"] > 0 else 0.0
+        start = time.time()
+        sent = 0
+        for _ in range(opts["updates"]):
+            for path, _kind in files:
+                if interval:
+                    delay = start + sent * interval - time.time()
+                    if delay > 0:
+                        time.sleep(delay)
+                fifo.write(f"{path} Updated IsFile\0".encode())
+                last_event[path] = time.time()
+                sent += 1
+        replayed = time.time()
+
+        # Each note fires both watchers; only submitted tasks pass the condition
+        expected = set()
+        for path, kind in files:
+            if kind in ("note", "submit"):
+                expected.update((w, path) for w in env_paths["watchers"])
+
+        # Drained once every expected action ran, or nothing new for a while
+        seen_count, idle_since = -1, time.monotonic()
+        while True:
+            actions = read_actions(env_paths["actions"])
+            done = {(w, p) for _, w, p in actions} >= expected
+            if len(actions) != seen_count:
+                seen_count, idle_since = len(actions), time.monotonic()
+            if done or time.monotonic() - idle_since > opts["timeout"]:
+                break
+            time.sleep(0.05)
+        drained = max([float(t) for t, _, _ in actions] + [replayed])
+
+        stats = read_stats(daemon.pid, env_paths["state"])
+        cpu1, rss = proc_usage(daemon.pid)
+        fifo.close()
+
+        latencies, counts = [], {}
+        for t, w, p in actions:
+            counts[(w, p)] = counts.get((w, p), 0) + 1
+            if counts[(w, p)] == 1 and p in last_event:
+                latencies.append((float(t) - last_event[p]) * 1000)
+        events = stats.get("events", sent) or 1
+        return {
+            "files": opts["files"],
+            "events": sent,
+            "debounce": opts["debounce"],
+            "actions": len(actions),
+            "p50_ms": round(percentile(latencies, 50), 1),
+            "p99_ms": round(percentile(latencies, 99), 1),
+            "events_per_sec": round(sent / max(drained - start, 1e-6), 1),
+            "forks_per_event": round((stats.get("forks", 0) - forks0) / events, 3),
+            "cpu_ms_per_event": round((cpu1 - cpu0) * 1000 / events, 3),
+            "rss_kb": rss,
+            "dropped": len(expected - set(counts)),
+            "duplicated": sum(n - 1 for n in counts.values()),
+        }
+    finally:
+        if daemon and daemon.poll() is None:
+            daemon.terminate()
+            try:
+                daemon.wait(timeout=5)
+            except subprocess.TimeoutExpired:
+                daemon.kill()
+        shutil.rmtree(base, ignore_errors=True)
+
+
+def report(result: dict, baseline: dict):
+    print(f"{result['files']} files, {result['events']} events, "
+          f"{result['actions']} actions (debounce {result['debounce']:g}s)")
+    for key, label, unit, lower in METRICS:
+        line = f"  {label:<12} {result[key]:>10g} {unit}"
+        if baseline and key in baseline:
+            delta = result[key] - baseline[key]
+            worse = delta > 0 if lower else delta < 0
+            if delta:
+                line += f"   ({delta:+g} vs baseline{', worse' if worse else ''})"
+        print(line)
+
+
+def main():
+    opts = parse_args(sys.argv[1:])
+    baseline = None
+    if opts["baseline"]:
+        with open(opts["baseline"]) as f:
+            baseline = json.load(f)
+    if not os.path.isdir(VAULT_WATCHERS):
+        print(f"Vault watchers not found: {VAULT_WATCHERS}", file=sys.stderr)
+        sys.exit(1)
+    result = bench(opts)
+    if opts["json"]:
+        print(json.dumps(result))
+    else:
+        report(result, baseline)
+    sys.exit(1 if result["dropped"] else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+watcher-logs - Print a watcher's log from a point in time, across rotations.
+
+watcherd archives rotated logs as logs/archive/<name>.<stamp>.log.gz, each
+with the sparse "epoch offset" index (<name>.idx) written alongside it.
+The index gives the offset of the last entry at or before --since, so only
+the segments that cover the window are opened, and each is read from that
+offset (a gzip segment is decompressed from its start, but not printed).
+
+Usage:
+    watcher-logs.py <name> --since <30m|2h|1d|epoch> [--no-follow]
+
+Without --no-follow, the current log is then followed (tail -F), which
+keeps up across the next rotation.
+"""
+
+import glob
+import gzip
+import os
+import re
+import shutil
+import sys
+import time
+
+STATE_DIR = os.environ.get("WATCHER_STATE_DIR", os.path.expanduser("~/.local/state/watchers"))
+LOG_DIR = os.path.join(STATE_DIR, "logs")
+ARCHIVE_DIR = os.path.join(LOG_DIR, "archive")
+UNITS = {"s": 1, "m": 60, "h": 3600, "d": 86400, "w": 7 * 86400}
+
+
+def parse_since(text: str) -> float:
+    m = re.fullmatch(r"(\d+)([smhdw]?)", text)
+    if not m:
+        raise ValueError(text)
+    if not m.group(2):
+        return float(m.group(1))  # epoch
+    return time.time() - int(m.group(1)) * UNITS[m.group(2)]
+
+
+def read_index(path: str) -> list:
+    """[(epoch, offset)], oldest first."""
+    entries = []
+    try:
+        with open(path) as f:
+            for line in f:
+                parts = line.split()
+                if len(parts) == 2:
+                    entries.append((float(parts[0]), int(parts[1])))
+    except (OSError, ValueError):
+        pass
+    return entries
+
+
+def segments(name: str) -> list:
+    """[(log path, index entries)] oldest first; the current log is last."""
+    found = []
+    for idx in glob.glob(os.path.join(glob.escape(ARCHIVE_DIR), glob.escape(name) + ".*.idx")):
+        base = idx[:-len(".idx")]
+        if not re.fullmatch(r"\d{8}-\d{6}", base.rsplit(".", 1)[1]):
+            continue
+        # .log while gzip is still running, .log.gz after
+        log = base + ".log" if os.path.exists(base + ".log") else base + ".log.gz"
+        if os.path.exists(log):
+            found.append((log, read_index(idx)))
+    found.sort()
+    found.append((os.path.join(LOG_DIR, f"{name}.log"), read_index(os.path.join(LOG_DIR, f"{name}.idx"))))
+    return found
+
+
+def start_offset(index: list, since: float) -> int:
+    offset = 0
+    for epoch, off in index:
+        if epoch > since:
+            break
+        offset = off
+    return offset
+
+
+def main():
+    args = sys.argv[1:]
+    follow = "--no-follow" not in args
+    args = [a for a in args if a != "--no-follow"]
+    try:
+        if len(args) != 3 or args[1] != "--since":
+            raise ValueError
+        name, since = args[0], parse_since(args[2])
+    except ValueError:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+    segs = segments(name)
+    current = segs[-1][0]
+    if not os.path.exists(current) and len(segs) == 1:
+        print(f"No log file for {name}", file=sys.stderr)
+        sys.exit(1)
+
+    out = sys.stdout.buffer
+    end = 0
+    for i, (path, index) in enumerate(segs):
+        # Everything in a segment is older than the next one's first entry
+        if i + 1 < len(segs) and segs[i + 1][1] and segs[i + 1][1][0][0] <= since:
+            continue
+        offset = start_offset(index, since)
+        opener = gzip.open if path.endswith(".gz") else open
+        end = 0  # tail -F offset: only what was printed of the current log
+        try:
+            with opener(path, "rb") as f:
+                f.seek(offset)
+                shutil.copyfileobj(f, out)
+                end = f.tell()
+        except OSError:
+            continue
+    out.flush()
+
+    if follow:
+        os.execvp("tail", ["tail", "-F", "-c", f"+{end + 1}", current])
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,1583 @@
+#!/usr/bin/env python3
+"""
+watcherd - Single-process daemon for fswatch and cron watchers.
+
+Loads every skills/*/*/watchers/*.yaml at once, shares one event source
+(fswatch, or inotifywait on Linux) per watched root, matches rules with
+pre-compiled regexes in-process and only forks when an action fires.
+Cron watchers are scheduled in-process too (CronExpr, timer heap), with
+jitter, catch-up after sleep and a max_concurrent guard.
+
+Per watcher, rules are compiled into one matcher: a combined regex rejects
+unrelated paths in a single search, and a trie of the rules' literal
+prefixes (^Tasks/...) narrows the rules tried for the rest. A rule's
+`condition` is checked once the path's debounce expires, not per event,
+and its result is cached by file content: an autosaving editor does not
+re-run it until the content changes.
+
+Actions are memoised: a rule or cron job with a `fingerprint` (file
+content, parsed yaml, a glob set and/or a command's output) is skipped
+while its inputs hash to what its last successful run saw, a cron
+`precheck` that fails skips the run, and the same argv for the same file
+version dispatched by another watcher within its `dedup` window runs once.
+
+Every trigger, skip and finished action is appended to the shared metrics
+log (zenix/lib/metrics.py: exit code, duration, debounce wait), which the
+scan pass exports as an OpenMetrics textfile for `zenix stats`.
+
+Logs rotate on the scan pass: a watcher log past LOG_MAX bytes or LOG_AGE
+seconds (and watcherd.log past LOG_MAX) moves to logs/archive/ once no
+action of that watcher is running, is gzipped there by a child and the
+oldest past LOG_KEEP are pruned. Each watcher log has a sparse
+"epoch offset" index (<name>.idx, one entry per INDEX_STEP at most) that
+moves with it, so `watcher logs <name> --since` seeks instead of scanning.
+
+Usage:
+    watcherd.py              Run in foreground (started by `watcher start`)
+    watcherd.py --check      Load config, print watchers and rules, exit
+
+Signals:
+    SIGHUP                   Reload yaml files and the disabled list
+    SIGUSR1                  Write counters to $STATE_DIR/stats
+    SIGTERM / SIGINT         Stop event sources and exit
+
+State is published on a status board, $STATE_DIR/status (see StatusBoard),
+for `watcher status` and `zenix doctor`. The stats file holds
+"name value" lines: events, matched, conditions, conditions_cached,
+actions, forks, unchanged, duplicates, prechecks.
+"""
+
+import fcntl
+import glob
+import hashlib
+import heapq
+import itertools
+import json
+import mmap
+import os
+import random
+import re
+import selectors
+import shlex
+import shutil
+import signal
+import subprocess
+import sys
+import time
+from datetime import datetime, timedelta
+from typing import Optional
+
+# Shared yaml parser and cache (skills/system/zenix/lib/config_cache.py)
+sys.dont_write_bytecode = True  # keep __pycache__ out of the watched skills tree
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "../../zenix/lib"))
+import config_cache  # noqa: E402
+import metrics  # noqa: E402
+import skill_check  # noqa: E402
+
+ZENIX_ROOT = os.environ.get("ZENIX_ROOT", os.path.expanduser("~/.zenix"))
+STATE_DIR = os.environ.get("WATCHER_STATE_DIR", os.path.expanduser("~/.local/state/watchers"))
+LOG_DIR = os.path.join(STATE_DIR, "logs")
+DISABLED_FILE = os.path.join(STATE_DIR, "disabled")
+STATUS_FILE = os.path.join(STATE_DIR, "status")
+STATS_FILE = os.path.join(STATE_DIR, "stats")
+FINGERPRINT_FILE = os.path.join(STATE_DIR, "fingerprints")
+ARCHIVE_DIR = os.path.join(LOG_DIR, "archive")
+DAEMON_LOG = os.path.join(LOG_DIR, "watcherd.log")
+SKILLS_DIR = os.path.join(ZENIX_ROOT, "skills")
+CONDITION_CACHE_MAX = 4096
+# Skill checks are re-read this often (and soon after a change under
+# skills/ when a watcher covers it)
+SCAN_INTERVAL = 60
+# A cron run this late was missed (machine asleep), not just delayed; the
+# loop wakes at least this often so a wall-clock jump is noticed
+CRON_GRACE = 90
+CRON_WAKE_MAX = 60
+# Default `dedup` window: the same action on the same file version started
+# by another watcher this recently is not run again
+DEDUP_WINDOW = 60
+# An event source that exits is restarted on its own after 1s, doubling up
+# to this while it keeps failing (one that ran this long starts over at 1s)
+SOURCE_BACKOFF_MAX = 300
+# Log rotation: size (bytes), age (seconds), archives kept per log; time
+# between index entries (seconds)
+LOG_MAX = int(os.environ.get("WATCHER_LOG_MAX") or 8 * 1024 * 1024)
+LOG_AGE = int(os.environ.get("WATCHER_LOG_AGE") or 86400)
+LOG_KEEP = int(os.environ.get("WATCHER_LOG_KEEP") or 14)
+INDEX_STEP = 60
+
+# fswatch event flag names (used to split `-x` output into path + flags)
+FSWATCH_FLAGS = {
+    "NoOp", "PlatformSpecific", "Created", "Updated", "Removed", "Renamed",
+    "OwnerModified", "AttributeModified", "MovedFrom", "MovedTo", "IsFile",
+    "IsDir", "IsSymLink", "Link", "Overflow", "CloseWrite",
+}
+
+# inotifywait event names → fswatch event flags
+INOTIFY_FLAGS = {
+    "CREATE": "Created",
+    "MODIFY": "Updated",
+    "CLOSE_WRITE": "Updated",
+    "ATTRIB": "AttributeModified",
+    "MOVED_FROM": "Renamed",
+    "MOVED_TO": "Renamed",
+    "DELETE": "Removed",
+    "ISDIR": "IsDir",
+}
+
+
+def log(msg: str):
+    """Daemon-level log line (stdout is redirected to watcherd.log)."""
+    print(f"{datetime.now():%H:%M:%S} [watcherd] {msg}", flush=True)
+
+
+def now_hms() -> str:
+    return datetime.now().strftime("%H:%M:%S")
+
+
+# ─────────────────────────────────────────────────────────────
+# YAML loading
+# ─────────────────────────────────────────────────────────────
+
+def load_yaml(path: str) -> dict:
+    """Load a watcher yaml through the shared config cache.
+
+    config_cache is deliberately lenient instead of PyYAML: existing
+    watchers use escapes like "\\.DS_Store" that strict yaml rejects.
+    """
+    data = config_cache.load(path)
+    return data if isinstance(data, dict) else {}
+
+
+def as_list(value) -> list:
+    if value is None or value == "":
+        return []
+    if isinstance(value, list):
+        return [str(v) for v in value]
+    return [str(value)]
+
+
+# ─────────────────────────────────────────────────────────────
+# Watchers and rules
+# ─────────────────────────────────────────────────────────────
+
+class Rule:
+    def __init__(self, spec: dict):
+        self.match = re.compile(str(spec.get("match", "")))
+        exclude = spec.get("exclude")
+        self.exclude = re.compile(str(exclude)) if exclude else None
+        self.condition = str(spec.get("condition") or "")
+        self.action = str(spec.get("action") or "")
+        self.batch = truthy(spec.get("batch"), False)
+        self.fingerprint = Fingerprint(spec["fingerprint"]) if spec.get("fingerprint") else None
+        self.prefix = literal_prefix(self.match.pattern)
+
+    def matches(self, rel_path: str) -> bool:
+        if not self.match.search(rel_path):
+            return False
+        if self.exclude and self.exclude.search(rel_path):
+            return False
+        return True
+
+
+class Fingerprint:
+    """Input fingerprint of a rule or cron job (yaml `fingerprint:`).
+
+        fingerprint: content       sha1 of the triggering file
+        fingerprint: yaml          its parsed yaml (comments/whitespace ignored)
+        fingerprint:
+          files: content|yaml      the triggering file, as above
+          glob: [pattern, ...]     path, mtime and size of every match
+                                   (relative to ZENIX_ROOT, ** allowed)
+          cmd: <shell command>     its stdout (the file path is "$1")
+
+    All parts given are hashed together.
+    """
+
+    def __init__(self, spec):
+        if isinstance(spec, dict):
+            self.files = str(spec.get("files") or "")
+            self.globs = as_list(spec.get("glob"))
+            self.cmd = str(spec.get("cmd") or "")
+        else:
+            self.files, self.globs, self.cmd = str(spec), [], ""
+        if self.files not in ("", "content", "yaml"):
+            raise ValueError(f"fingerprint files must be content or yaml: {self.files!r}")
+
+    def describe(self) -> str:
+        parts = [self.files] if self.files else []
+        parts += [f"glob {g}" for g in self.globs]
+        if self.cmd:
+            parts.append(f"cmd {self.cmd}")
+        return ", ".join(parts)
+
+    def digest(self, path: str, stats: dict) -> Optional[str]:
+        """Hex digest of the inputs (None: unreadable, do not memoise)."""
+        h = hashlib.sha1()
+        if self.files and path:
+            try:
+                with open(path, "rb") as f:
+                    data = f.read()
+            except OSError:
+                return None
+            if self.files == "yaml":
+                parsed = config_cache.parse(data.decode("utf-8", "replace"))
+                data = json.dumps(parsed, sort_keys=True, default=str).encode()
+            h.update(data)
+        for pattern in self.globs:
+            for match in sorted(glob.glob(os.path.join(ZENIX_ROOT, pattern), recursive=True)):
+                try:
+                    st = os.stat(match)
+                except OSError:
+                    continue
+                h.update(f"{match}\0{st.st_mtime_ns}\0{st.st_size}\n".encode())
+        if self.cmd:
+            stats["forks"] += 1
+            result = subprocess.run(["bash", "-c", self.cmd, "fingerprint", path], cwd=ZENIX_ROOT,
+                                    stdin=subprocess.DEVNULL, stdout=subprocess.PIPE,
+                                    stderr=subprocess.DEVNULL)
+            if result.returncode != 0:
+                return None
+            h.update(result.stdout)
+        return h.hexdigest()
+
+
+def literal_prefix(pattern: str) -> str:
+    """Literal text every match of an ^-anchored pattern starts with ("" if none)."""
+    if not pattern.startswith("^") or "|" in pattern:
+        return ""
+    prefix = []
+    i = 1
+    while i < len(pattern):
+        c = pattern[i]
+        if c == "\\" and i + 1 < len(pattern) and not pattern[i + 1].isalnum():
+            c, step = pattern[i + 1], 2
+        elif c in ".^$*+?{}[]()\\":
+            break
+        else:
+            step = 1
+        if pattern[i + step:i + step + 1] in ("*", "?", "{"):
+            break  # quantified: this character is optional or repeated
+        prefix.append(c)
+        i += step
+    return "".join(prefix)
+
+
+def combine(patterns: list):
+    """One regex matching wherever any of patterns matches (None if unsafe)."""
+    if not patterns:
+        return None
+    # Group references would point at the wrong group once combined
+    if any(re.search(r"\\\d|\(\?P[=<]", p) for p in patterns):
+        return None
+    try:
+        return re.compile("|".join(f"(?:{p})" for p in patterns))
+    except re.error:
+        return None
+
+
+class PrefixTrie:
+    """Rule indices keyed by literal path prefix; lookup walks the path once."""
+
+    def __init__(self, rules: list):
+        self.root: dict = {}
+        for i, rule in enumerate(rules):
+            node = self.root
+            for c in rule.prefix:
+                node = node.setdefault(c, {})
+            node.setdefault(None, []).append(i)
+
+    def candidates(self, path: str) -> list:
+        node = self.root
+        found = list(node.get(None, ()))
+        for c in path:
+            node = node.get(c)
+            if node is None:
+                break
+            found.extend(node.get(None, ()))
+        return sorted(found)
+
+
+class Job:
+    """Log file and last-run bookkeeping shared by watchers and cron jobs."""
+
+    kind = ""
+
+    def __init__(self, yaml_file: str, cfg: dict):
+        self.yaml_file = yaml_file
+        self.name = str(cfg["name"])
+        self.log_path = os.path.join(LOG_DIR, f"{self.name}.log")
+        self.index_path = os.path.join(LOG_DIR, f"{self.name}.idx")
+        self.log_file = None
+        # Epoch of the current log's first and latest index entries
+        self.opened = 0.0
+        self.indexed = 0.0
+        # Last action: epoch started, exit code, duration (ms); count since load
+        self.last_trigger = 0
+        self.last_exit: Optional[int] = None
+        self.last_ms = 0
+        self.triggers = 0
+
+    def open_log(self):
+        self.log_file = open(self.log_path, "a", buffering=1)
+        self.opened, self.indexed = first_index(self.index_path), 0.0
+        self.write("")
+        self.write(f"=== {self.name} started at {datetime.now():%c} ===")
+        for line in self.describe():
+            self.write(line)
+        self.write("")
+
+    def describe(self) -> list:
+        return []
+
+    def close_log(self):
+        if self.log_file:
+            self.write(f"=== {self.name} stopped at {datetime.now():%c} ===")
+            self.log_file.close()
+            self.log_file = None
+
+    def write(self, line: str):
+        if self.log_file:
+            self.mark()
+            self.log_file.write(line + "\n")
+
+    def mark(self):
+        """Index the current end of the log (at most once per INDEX_STEP)."""
+        now = time.time()
+        if not self.log_file or now - self.indexed < INDEX_STEP:
+            return
+        self.indexed = now
+        self.opened = self.opened or now
+        try:
+            with open(self.index_path, "a") as f:
+                f.write(f"{int(now)} {os.fstat(self.log_file.fileno()).st_size}\n")
+        except OSError:
+            pass
+
+    def busy(self) -> bool:
+        return False
+
+    def rotate_due(self) -> bool:
+        try:
+            size = os.fstat(self.log_file.fileno()).st_size
+        except (AttributeError, OSError, ValueError):
+            return False
+        return size > LOG_MAX or (size > 0 and self.opened and time.time() - self.opened >= LOG_AGE)
+
+    def rotate(self) -> str:
+        """Move the log and its index to the archive; returns the archived log."""
+        base = archive_base(self.name)
+        self.log_file.close()
+        os.replace(self.log_path, base + ".log")
+        if os.path.exists(self.index_path):
+            os.replace(self.index_path, base + ".idx")
+        self.log_file = open(self.log_path, "a", buffering=1)
+        self.opened, self.indexed = 0.0, 0.0
+        self.write(f"=== {self.name} log rotated at {datetime.now():%c} "
+                   f"(previous: archive/{os.path.basename(base)}.log.gz) ===")
+        for line in self.describe():
+            self.write(line)
+        return base + ".log"
+
+    def spawn(self, argv: list) -> subprocess.Popen:
+        self.last_trigger = int(time.time())
+        self.triggers += 1
+        # ZENIX_WATCHER: agent runs started here record it with their cost
+        return subprocess.Popen(argv, cwd=ZENIX_ROOT, stdin=subprocess.DEVNULL,
+                                stdout=self.log_file, stderr=subprocess.STDOUT,
+                                env=dict(os.environ, ZENIX_WATCHER=self.name))
+
+    def adopt(self, old: "Job"):
+        """Take over the run state of the job this one replaces on a reload."""
+        self.last_trigger, self.last_exit = old.last_trigger, old.last_exit
+        self.last_ms, self.triggers = old.last_ms, old.triggers
+
+    def finished(self, code: int, started: float, run: dict):
+        """Record a finished action; run: act, and wait (ms) / files for fswatch."""
+        self.last_exit = code
+        self.last_ms = int((time.time() - started) * 1000)
+        metrics.record("action", self.name, kind=self.kind, exit=code, ms=self.last_ms, **run)
+
+
+class Watcher(Job):
+    kind = "fswatch"
+
+    def __init__(self, yaml_file: str, cfg: dict):
+        super().__init__(yaml_file, cfg)
+        self.debounce = float(cfg.get("debounce") or 15)
+        self.events = set(as_list(cfg.get("events")))
+        self.removals = "Removed" in self.events  # also deliver paths that no longer exist
+        self.exclude_patterns = as_list(cfg.get("exclude"))
+        self.excludes = [re.compile(p) for p in self.exclude_patterns]
+        self.exclude_any = combine(self.exclude_patterns)
+        self.rules = [Rule(r) for r in (cfg.get("rules") or []) if isinstance(r, dict) and r.get("match")]
+        self.match_any = combine([r.match.pattern for r in self.rules])
+        self.trie = PrefixTrie(self.rules)
+        self.root = resolve_root(str(cfg.get("path") or ""))
+        dedup = cfg.get("dedup")
+        self.dedup = DEDUP_WINDOW if dedup is None or dedup == "" else float(dedup)
+        # Ready ([paths], rule) waiting for the previous action of this watcher
+        self.ready: list = []
+        # Batch rules: action → (first held, [paths], rule) until the burst settles
+        self.held: dict = {}
+        self.running: Optional[subprocess.Popen] = None
+        self.started = 0.0
+        self.run: dict = {}  # metrics of the running action: act, wait, files
+        # Fingerprint keys recorded for the running action (dropped if it fails)
+        self.memo: list = []
+
+    def describe(self) -> list:
+        return [f"Watching: {self.root}", f"Debounce: {self.debounce:g}s", f"Loaded {len(self.rules)} rules"]
+
+    def accepts(self, path: str, flags: set) -> bool:
+        """Event filter equivalent to fswatch --event/--exclude for this watcher."""
+        if self.events and flags and not (flags & self.events):
+            return False
+        if self.exclude_any:
+            return not self.exclude_any.search(path)
+        return not any(p.search(path) for p in self.excludes)
+
+    def busy(self) -> bool:
+        return self.running is not None and self.running.poll() is None
+
+    def adopt(self, old: "Job"):
+        super().adopt(old)
+        if isinstance(old, Watcher):
+            # Queued actions keep the rule they were queued with
+            self.running, self.started, self.run, self.memo = old.running, old.started, old.run, old.memo
+            self.ready, self.held = old.ready, old.held
+
+    def candidate_rules(self, rel_path: str) -> list:
+        """Rules whose match/exclude accept rel_path, in yaml order."""
+        if self.match_any and not self.match_any.search(rel_path):
+            return []
+        return [self.rules[i] for i in self.trie.candidates(rel_path) if self.rules[i].matches(rel_path)]
+
+
+# ─────────────────────────────────────────────────────────────
+# Cron
+# ─────────────────────────────────────────────────────────────
+
+class CronExpr:
+    """Five-field cron expression (or @hourly/@daily/...) in local time.
+
+    Fields take *, N, A-B, lists and /step, month and weekday names, and
+    7 for Sunday. As in cron, a restricted day-of-month and day-of-week
+    match when either does.
+    """
+
+    ALIASES = {
+        "@yearly": "0 0 1 1 *", "@annually": "0 0 1 1 *", "@monthly": "0 0 1 * *",
+        "@weekly": "0 0 * * 0", "@daily": "0 0 * * *", "@midnight": "0 0 * * *",
+        "@hourly": "0 * * * *",
+    }
+    MONTHS = {m: i + 1 for i, m in enumerate(
+        ("jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"))}
+    WEEKDAYS = {d: i for i, d in enumerate(("sun", "mon", "tue", "wed", "thu", "fri", "sat"))}
+
+    def __init__(self, text: str):
+        self.text = text.strip()
+        fields = self.ALIASES.get(self.text, self.text).split()
+        if len(fields) != 5:
+            raise ValueError(f"expected 5 fields: {text!r}")
+        self.minutes = self.field(fields[0], 0, 59)
+        self.hours = self.field(fields[1], 0, 23)
+        self.days = self.field(fields[2], 1, 31)
+        self.months = self.field(fields[3], 1, 12, self.MONTHS)
+        self.weekdays = {d % 7 for d in self.field(fields[4], 0, 7, self.WEEKDAYS)}
+        self.any_day = fields[2] == "*"
+        self.any_weekday = fields[4] == "*"
+
+    @staticmethod
+    def field(text: str, lo: int, hi: int, names: dict = None) -> list:
+        def value(v: str) -> int:
+            n = names.get(v.lower()) if names else None
+            n = int(v) if n is None else n
+            if not lo <= n <= hi:
+                raise ValueError(f"{n} out of range {lo}-{hi}")
+            return n
+
+        values = set()
+        for part in text.split(","):
+            spec, _, step = part.partition("/")
+            if spec == "*":
+                start, end = lo, hi
+            elif "-" in spec:
+                a, b = spec.split("-", 1)
+                start, end = value(a), value(b)
+            else:
+                start = value(spec)
+                end = hi if step else start
+            values.update(range(start, end + 1, int(step) if step else 1))
+        return sorted(values)
+
+    def day_matches(self, d: datetime) -> bool:
+        if d.month not in self.months:
+            return False
+        in_month = d.day in self.days
+        in_week = (d.weekday() + 1) % 7 in self.weekdays
+        if self.any_day or self.any_weekday:
+            return in_month and in_week
+        return in_month or in_week
+
+    def next_after(self, t: float) -> float:
+        """Epoch of the first matching minute strictly after t."""
+        d = datetime.fromtimestamp(t).replace(second=0, microsecond=0) + timedelta(minutes=1)
+        for _ in range(366 * 5):
+            if self.day_matches(d):
+                for h in self.hours:
+                    if h < d.hour:
+                        continue
+                    for m in self.minutes:
+                        if h == d.hour and m < d.minute:
+                            continue
+                        return d.replace(hour=h, minute=m).timestamp()
+            d = (d + timedelta(days=1)).replace(hour=0, minute=0)
+        raise ValueError(f"never fires: {self.text}")
+
+
+NOW_RE = re.compile(r"\{now(?::([^}]*))?\}")
+
+
+def expand_now(arg: str) -> str:
+    """{now} / {now:<strftime>} → the current local time."""
+    now = datetime.now().astimezone()
+    return NOW_RE.sub(lambda m: now.strftime(m.group(1) or "%Y-%m-%d %H:%M"), arg)
+
+
+def truthy(value, default: bool) -> bool:
+    if value is None or value == "":
+        return default
+    return str(value).lower() not in ("false", "no", "off", "0")
+
+
+class CronJob(Job):
+    kind = "cron"
+
+    def __init__(self, yaml_file: str, cfg: dict):
+        super().__init__(yaml_file, cfg)
+        self.schedule = CronExpr(str(cfg.get("schedule") or ""))
+        self.action = str(cfg.get("action") or "")
+        self.jitter = float(cfg.get("jitter") or 0)
+        self.catch_up = truthy(cfg.get("catch_up"), True)
+        self.max_concurrent = max(1, int(cfg.get("max_concurrent") or 1))
+        self.precheck = str(cfg.get("precheck") or "")
+        self.fingerprint = Fingerprint(cfg["fingerprint"]) if cfg.get("fingerprint") else None
+        self.running: list = []  # [(Popen, started, fingerprint keys)]
+        self.act = os.path.basename(self.action.split()[0]) if self.action.split() else ""
+        self.slot = 0.0          # next scheduled minute
+        self.fire_at = 0.0       # slot + jitter
+
+    def describe(self) -> list:
+        lines = [f"Schedule: {self.schedule.text}", f"Action: {self.action}",
+                 f"Jitter: {self.jitter:g}s, catch-up: {'on' if self.catch_up else 'off'}, "
+                 f"max concurrent: {self.max_concurrent}"]
+        if self.precheck:
+            lines.append(f"Precheck: {self.precheck}")
+        if self.fingerprint:
+            lines.append(f"Fingerprint: {self.fingerprint.describe()}")
+        return lines
+
+    def busy(self) -> bool:
+        return any(proc.poll() is None for proc, _, _ in self.running)
+
+    def adopt(self, old: "Job"):
+        super().adopt(old)
+        if isinstance(old, CronJob):
+            self.running = old.running  # still counts toward max_concurrent
+
+    def plan(self, after: float):
+        self.slot = self.schedule.next_after(after)
+        self.fire_at = self.slot + (random.uniform(0, self.jitter) if self.jitter else 0.0)
+
+    def reap(self) -> list:
+        """Collect finished runs; returns the fingerprint keys of failed ones."""
+        still, failed = [], []
+        for proc, started, memo in self.running:
+            code = proc.poll()
+            if code is None:
+                still.append((proc, started, memo))
+            else:
+                self.finished(code, started, {"act": self.act})
+                if code != 0:
+                    failed += memo
+        self.running = still
+        return failed
+
+
+# ─────────────────────────────────────────────────────────────
+# Log archive
+# ─────────────────────────────────────────────────────────────
+
+def first_index(index_path: str) -> float:
+    """Epoch of a log's first index entry (0 if it has none yet)."""
+    try:
+        with open(index_path) as f:
+            return float(f.readline().split()[0])
+    except (OSError, IndexError, ValueError):
+        return 0.0
+
+
+def archive_base(name: str) -> str:
+    """archive/<name>.<YYYYmmdd-HHMMSS>, a second later if that one is taken."""
+    os.makedirs(ARCHIVE_DIR, exist_ok=True)
+    t = time.time()
+    while True:
+        base = os.path.join(ARCHIVE_DIR, f"{name}.{datetime.fromtimestamp(t):%Y%m%d-%H%M%S}")
+        if not glob.glob(glob.escape(base) + ".log*"):
+            return base
+        t += 1
+
+
+def prune_archive(name: str):
+    """Keep the newest LOG_KEEP archives of a log (with their indexes)."""
+    stamps = sorted({f[len(name) + 1:].split(".")[0] for f in os.listdir(ARCHIVE_DIR)
+                     if re.fullmatch(re.escape(name) + r"\.\d{8}-\d{6}\.(log|log\.gz|idx)", f)})
+    for stamp in stamps[:-LOG_KEEP] if LOG_KEEP > 0 else []:
+        for ext in (".log", ".log.gz", ".idx"):
+            try:
+                os.remove(os.path.join(ARCHIVE_DIR, f"{name}.{stamp}{ext}"))
+            except FileNotFoundError:
+                pass
+
+
+def resolve_root(path: str) -> str:
+    path = os.path.expanduser(path)
+    if not path.startswith("/"):
+        path = os.path.join(ZENIX_ROOT, path)
+    # fswatch reports real paths, so match against the resolved root
+    return os.path.realpath(path)
+
+
+def read_disabled() -> set:
+    try:
+        with open(DISABLED_FILE) as f:
+            return {line.strip() for line in f if line.strip()}
+    except FileNotFoundError:
+        return set()
+
+
+def discover() -> list:
+    """Load every enabled fswatch watcher and cron job."""
+    disabled = read_disabled()
+    watchers = []
+    for yaml_file in sorted(glob.glob(os.path.join(ZENIX_ROOT, "skills", "*", "*", "watchers", "*.yaml"))):
+        try:
+            cfg = load_yaml(yaml_file)
+        except (OSError, ValueError) as e:
+            log(f"skip {yaml_file}: {e}")
+            continue
+        if not isinstance(cfg, dict) or cfg.get("type") not in ("fswatch", "cron") or not cfg.get("name"):
+            continue
+        if str(cfg["name"]) in disabled:
+            continue
+        if cfg["type"] == "cron":
+            try:
+                watchers.append(CronJob(yaml_file, cfg))
+            except ValueError as e:
+                log(f"skip {yaml_file}: bad schedule or fingerprint ({e})")
+            continue
+        try:
+            w = Watcher(yaml_file, cfg)
+        except re.error as e:
+            log(f"skip {yaml_file}: bad regex ({e})")
+            continue
+        except ValueError as e:
+            log(f"skip {yaml_file}: bad rule ({e})")
+            continue
+        if not os.path.isdir(w.root):
+            log(f"skip {w.name}: watch path does not exist: {w.root}")
+            continue
+        watchers.append(w)
+    return watchers
+
+
+# ─────────────────────────────────────────────────────────────
+# Event sources (one per distinct root)
+# ─────────────────────────────────────────────────────────────
+
+class Source:
+    """A single fswatch/inotifywait subscription shared by several watchers."""
+
+    def __init__(self, root: str, watchers: list):
+        self.root = root
+        self.watchers = watchers
+        self.proc: Optional[subprocess.Popen] = None
+        self.buf = b""
+        self.sep = b"\0"
+        self.kind = ""
+        self.started = 0.0
+        self.failures = 0   # exits in a row, for the restart backoff
+        self.retry_at: Optional[float] = None
+
+    def command(self) -> list:
+        # Only filter in fswatch what every watcher on this root filters
+        all_events = all(w.events for w in self.watchers)
+        events = sorted(set().union(*(w.events for w in self.watchers))) if all_events else []
+        common_excludes = set(self.watchers[0].exclude_patterns)
+        for w in self.watchers[1:]:
+            common_excludes &= set(w.exclude_patterns)
+
+        if shutil.which("fswatch"):
+            self.kind, self.sep = "fswatch", b"\0"
+            cmd = ["fswatch", "-0", "-x", "-r"]
+            for e in events:
+                cmd += ["--event", e]
+            for p in sorted(common_excludes):
+                cmd += ["--exclude", p]
+            return cmd + [self.root]
+        if shutil.which("inotifywait"):
+            self.kind, self.sep = "inotify", b"\n"
+            return ["inotifywait", "-m", "-r", "-q", "--format", "%e %w%f",
+                    "-e", "create,modify,close_write,attrib,moved_from,moved_to,delete",
+                    self.root]
+        raise RuntimeError("neither fswatch nor inotifywait is installed")
+
+    def start(self):
+        cmd = self.command()
+        self.proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+                                     stdin=subprocess.DEVNULL)
+        os.set_blocking(self.proc.stdout.fileno(), False)
+        self.started, self.buf = time.monotonic(), b""
+        if not self.failures:
+            log(f"{self.kind} on {self.root} ({', '.join(w.name for w in self.watchers)})")
+
+    def stop(self):
+        if self.proc and self.proc.poll() is None:
+            self.proc.terminate()
+            try:
+                self.proc.wait(timeout=2)
+            except subprocess.TimeoutExpired:
+                self.proc.kill()
+        if self.proc:
+            self.proc.stdout.close()
+        self.proc = None
+
+    def read_events(self) -> list:
+        """Drain available output; returns [(path, flags)]. Empty + EOF → []"""
+        try:
+            chunk = self.proc.stdout.read(65536)
+        except BlockingIOError:
+            return []
+        if not chunk:
+            return []
+        self.buf += chunk
+        *records, self.buf = self.buf.split(self.sep)
+        return [self.parse(r.decode("utf-8", "surrogateescape")) for r in records if r]
+
+    def parse(self, record: str):
+        if self.kind == "inotify":
+            names, _, path = record.partition(" ")
+            return path, {INOTIFY_FLAGS[n] for n in names.split(",") if n in INOTIFY_FLAGS}
+        parts = record.split(" ")
+        flags = set()
+        while len(parts) > 1 and parts[-1] in FSWATCH_FLAGS:
+            flags.add(parts.pop())
+        return " ".join(parts), flags
+
+
+# ─────────────────────────────────────────────────────────────
+# Debounce scheduler
+# ─────────────────────────────────────────────────────────────
+
+class DebounceScheduler:
+    """Min-heap of debounce deadlines.
+
+    A repeated event for a pending key only moves its deadline; the old
+    heap entry is left behind and skipped when it surfaces. The daemon
+    sleeps exactly until the earliest live deadline.
+    """
+
+    def __init__(self):
+        self.heap: list = []
+        self.entries: dict = {}  # key → (deadline, payload)
+        self.depth: dict = {}    # group (watcher name) → pending count
+        self.seq = itertools.count()
+
+    def push(self, key: tuple, delay: float, payload) -> bool:
+        """Schedule or reschedule key; True if it was not pending yet."""
+        deadline = time.monotonic() + delay
+        is_new = key not in self.entries
+        if is_new:
+            self.depth[key[0]] = self.depth.get(key[0], 0) + 1
+        self.entries[key] = (deadline, payload)
+        heapq.heappush(self.heap, (deadline, next(self.seq), key))
+        if len(self.heap) > 64 and len(self.heap) > 4 * len(self.entries):
+            self.compact()
+        return is_new
+
+    def __contains__(self, key) -> bool:
+        return key in self.entries
+
+    def _live_top(self):
+        while self.heap:
+            deadline, _, key = self.heap[0]
+            entry = self.entries.get(key)
+            if entry is not None and entry[0] == deadline:
+                return deadline, key
+            heapq.heappop(self.heap)
+        return None
+
+    def timeout(self) -> Optional[float]:
+        """Seconds until the next deadline (None when idle)."""
+        top = self._live_top()
+        if top is None:
+            return None
+        return max(0.0, top[0] - time.monotonic())
+
+    def pop_due(self) -> list:
+        """Remove and return payloads whose deadline has passed, in order."""
+        now = time.monotonic()
+        due = []
+        while True:
+            top = self._live_top()
+            if top is None or top[0] > now:
+                break
+            heapq.heappop(self.heap)
+            _, payload = self.entries.pop(top[1])
+            self.depth[top[1][0]] -= 1
+            due.append(payload)
+        return due
+
+    def drain(self) -> list:
+        """Remove and return every pending (key, seconds left, payload)."""
+        now = time.monotonic()
+        left = [(k, max(0.0, d - now), payload) for k, (d, payload) in self.entries.items()]
+        self.clear()
+        return left
+
+    def compact(self):
+        self.heap = [(d, next(self.seq), k) for k, (d, _) in self.entries.items()]
+        heapq.heapify(self.heap)
+
+    def clear(self):
+        self.heap.clear()
+        self.entries.clear()
+        self.depth.clear()
+
+
+# ─────────────────────────────────────────────────────────────
+# Status board
+# ─────────────────────────────────────────────────────────────
+
+class StatusBoard:
+    """Fixed-width text records in a memory-mapped file.
+
+    Every record is WIDTH bytes: space-padded text and a newline, so bash
+    reads the board with a plain `while read` and no parsing. The daemon
+    keeps the file mapped and overwrites a changed record in place; only a
+    change in the set of records rewrites the file (atomic rename).
+
+        watcherd <pid> <started> <scanned>
+        w <name> fswatch <state> <pending> <ready> <running pid> <last trigger> <exit> <ms> <triggers>
+        w <name> cron <state> <next run> <running> <max concurrent> <last trigger> <exit> <ms> <triggers> <schedule>
+        s <category>/<skill> <issues> <level>|<message>;...    (probe = too long, check directly)
+
+    Unknown values are "-". Readers trust the board only while <pid> lives.
+    """
+
+    WIDTH = 512
+
+    def __init__(self, path: str):
+        self.path = path
+        self.mm = None
+        self.slots: dict = {}  # key → record index
+        self.rows: dict = {}   # key → text
+
+    def record(self, text: str) -> bytes:
+        data = text.encode("utf-8", "replace")[:self.WIDTH - 1]
+        return data.ljust(self.WIDTH - 1) + b"\n"
+
+    def keys(self) -> list:
+        return sorted(self.slots, key=self.slots.get)
+
+    def rebuild(self, rows: list):
+        """Replace the board with [(key, text)]."""
+        tmp = self.path + ".tmp"
+        with open(tmp, "wb") as f:
+            for _, text in rows:
+                f.write(self.record(text))
+        os.replace(tmp, self.path)
+        self.close(remove=False)
+        self.slots = {key: i for i, (key, _) in enumerate(rows)}
+        self.rows = dict(rows)
+        if rows:
+            with open(self.path, "r+b") as f:
+                self.mm = mmap.mmap(f.fileno(), 0)
+
+    def set(self, key, text: str):
+        if self.rows.get(key) == text or key not in self.slots:
+            return
+        off = self.slots[key] * self.WIDTH
+        self.mm[off:off + self.WIDTH] = self.record(text)
+        self.rows[key] = text
+
+    def close(self, remove: bool = True):
+        if self.mm is not None:
+            self.mm.close()
+            self.mm = None
+        if remove:
+            try:
+                os.remove(self.path)
+            except FileNotFoundError:
+                pass
+
+
+def skill_row(skill_dir: str) -> str:
+    name = os.path.relpath(skill_dir, SKILLS_DIR)
+    try:
+        items = skill_check.check(skill_dir)
+    except OSError:
+        return f"s {name} - probe"
+    text = f"s {name} {skill_check.issues(items)} " + ";".join(f"{lvl}|{msg}" for lvl, msg in items)
+    if len(text.encode()) >= StatusBoard.WIDTH or any(c in msg for _, msg in items for c in ";|\n"):
+        return f"s {name} - probe"
+    return text
+
+
+# ─────────────────────────────────────────────────────────────
+# Daemon
+# ─────────────────────────────────────────────────────────────
+
+class Daemon:
+    def __init__(self):
+        self.watchers: list = []
+        self.sources: list = []
+        # Keyed by (watcher name, path)
+        self.pending = DebounceScheduler()
+        self.board = StatusBoard(STATUS_FILE)
+        self.cron: list = []
+        self.cron_heap: list = []  # (fire_at, seq, job)
+        self.cron_seq = itertools.count()
+        # Unloaded jobs whose actions were still running: reaped, not replaced
+        self.retired: list = []
+        self.started = int(time.time())
+        self.next_scan = 0.0
+        # Since start; forks counts every child (sources, conditions, actions)
+        self.stats = dict.fromkeys(
+            ("events", "matched", "conditions", "conditions_cached", "actions", "forks",
+             "unchanged", "duplicates", "prechecks"), 0)
+        # (condition, path) → (mtime_ns, size, content sha1, passed)
+        self.condition_cache: dict = {}
+        # "<job>\t<action>\t<path>" → input digest of the last successful run;
+        # kept across reloads and restarts
+        self.fingerprints = load_fingerprints()
+        # (argv, path, mtime_ns) → (monotonic started, watcher) for dedup
+        self.recent: dict = {}
+        # (watcher name, path) → monotonic first event, for the debounce wait
+        self.detected: dict = {}
+        self.metrics = metrics.Reader()
+        # gzip children compressing rotated logs
+        self.compressing: list = []
+        self.stats_requested = False
+        self.sel = selectors.DefaultSelector()
+        self.reload_requested = False
+        self.stop_requested = False
+        self.wake_r, self.wake_w = os.pipe()
+        os.set_blocking(self.wake_w, False)
+        self.sel.register(self.wake_r, selectors.EVENT_READ, None)
+
+    # Signals just poke the self-pipe; work happens in the main loop
+    def _signal(self, signum, _frame):
+        if signum == signal.SIGHUP:
+            self.reload_requested = True
+        elif signum == signal.SIGUSR1:
+            self.stats_requested = True
+        elif signum != signal.SIGCHLD:
+            self.stop_requested = True
+        try:
+            os.write(self.wake_w, b"x")
+        except BlockingIOError:
+            pass
+
+    def load(self):
+        for s in self.sources:
+            if s.proc:
+                self.sel.unregister(s.proc.stdout)
+            s.stop()
+        for w in self.watchers + self.cron:
+            w.close_log()
+        # A job of the same name takes over running actions, queued work and
+        # pending debounces, so a reload neither loses nor doubles any of them
+        old = {(j.kind, j.name): j for j in self.watchers + self.cron}
+        pending = self.pending.drain()
+        self.condition_cache.clear()
+
+        jobs = discover()
+        for job in jobs:
+            prev = old.pop((job.kind, job.name), None)
+            if prev:
+                job.adopt(prev)
+        self.retired += [j for j in old.values() if j.running]
+        self.watchers = [w for w in jobs if w.kind == "fswatch"]
+        self.cron = [j for j in jobs if j.kind == "cron"]
+        self.cron_heap = []
+        now = time.time()
+        for job in self.cron:
+            job.open_log()
+            self.schedule(job, now)
+
+        by_root: dict = {}
+        for w in self.watchers:
+            w.open_log()
+            by_root.setdefault(w.root, []).append(w)
+
+        by_name = {w.name: w for w in self.watchers}
+        for key, left, (_, path, _) in pending:
+            w = by_name.get(key[0])
+            rules = w.candidate_rules(path[len(w.root) + 1:]) if w and path.startswith(w.root + "/") else []
+            if rules:
+                self.pending.push(key, left, (w, path, rules))
+            else:
+                self.detected.pop(key, None)
+
+        self.sources = []
+        for root, group in sorted(by_root.items()):
+            src = Source(root, group)
+            try:
+                src.start()
+            except RuntimeError as e:
+                log(f"error: {e}")
+                break
+            self.stats["forks"] += 1
+            self.sel.register(src.proc.stdout, selectors.EVENT_READ, src)
+            self.sources.append(src)
+        log(f"loaded {len(self.watchers)} watcher(s) on {len(self.sources)} root(s), "
+            f"{len(self.cron)} cron job(s)")
+        self.next_scan = 0.0
+
+    # ── event sources ──
+
+    def source_exited(self, src: Source):
+        """Schedule a restart of this root alone, backing off while it fails."""
+        self.sel.unregister(src.proc.stdout)
+        code = src.proc.returncode
+        src.stop()
+        if time.monotonic() - src.started >= SOURCE_BACKOFF_MAX:
+            src.failures = 0
+        src.failures += 1
+        src.retry_at = time.monotonic() + min(SOURCE_BACKOFF_MAX, 2 ** (src.failures - 1))
+        if src.failures == 1:
+            log(f"event source for {src.root} exited ({code}); restarting, "
+                f"backing off up to {SOURCE_BACKOFF_MAX}s while it keeps exiting")
+
+    def restart_sources(self):
+        now = time.monotonic()
+        for src in self.sources:
+            if src.retry_at is None or src.retry_at > now:
+                continue
+            src.retry_at = None
+            try:
+                src.start()
+            except (RuntimeError, OSError) as e:
+                log(f"error: {e}")
+                continue
+            self.stats["forks"] += 1
+            self.sel.register(src.proc.stdout, selectors.EVENT_READ, src)
+
+    def source_timeout(self) -> Optional[float]:
+        retries = [s.retry_at for s in self.sources if s.retry_at is not None]
+        return max(0.0, min(retries) - time.monotonic()) if retries else None
+
+    # ── cron ──
+
+    def schedule(self, job: CronJob, after: float):
+        job.plan(after)
+        heapq.heappush(self.cron_heap, (job.fire_at, next(self.cron_seq), job))
+
+    def cron_timeout(self) -> Optional[float]:
+        if not self.cron_heap:
+            return None
+        return max(0.0, min(self.cron_heap[0][0] - time.time(), CRON_WAKE_MAX))
+
+    def reap_retired(self):
+        """Finish the bookkeeping (metrics, failed fingerprints) of actions
+        whose job was unloaded while they ran."""
+        for job in self.retired:
+            if isinstance(job, CronJob):
+                self.forget(job.reap())
+            else:
+                job.ready, job.held = [], {}
+                self.run_next(job)
+        self.retired = [j for j in self.retired if j.running]
+
+    def check_cron(self):
+        for job in self.cron:
+            self.forget(job.reap())
+        now = time.time()
+        while self.cron_heap and self.cron_heap[0][0] <= now:
+            _, _, job = heapq.heappop(self.cron_heap)
+            if job not in self.cron:
+                continue  # left over from before a reload
+            if now - job.fire_at > CRON_GRACE:
+                # Slept through it: every slot up to now was missed
+                missed, t = 0, job.slot
+                while t <= now and missed < 10000:
+                    missed, t = missed + 1, job.schedule.next_after(t)
+                if job.catch_up:
+                    job.write(f"{now_hms()} [CATCHUP] {missed} run(s) missed while asleep; running once")
+                    self.run_cron(job)
+                else:
+                    job.write(f"{now_hms()} [MISSED] {missed} run(s) while asleep")
+            else:
+                self.run_cron(job)
+            self.schedule(job, now)
+
+    def run_cron(self, job: CronJob):
+        metrics.record("trigger", job.name, kind=job.kind)
+        if len(job.running) >= job.max_concurrent:
+            job.write(f"{now_hms()} [SKIP] {len(job.running)} run(s) still going "
+                      f"(max_concurrent {job.max_concurrent})")
+            metrics.record("skip", job.name, reason="busy")
+            return
+        if job.precheck:
+            self.stats["prechecks"] += 1
+            self.stats["forks"] += 1
+            result = subprocess.run(["bash", "-c", job.precheck], cwd=ZENIX_ROOT,
+                                    stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL,
+                                    stderr=subprocess.DEVNULL)
+            if result.returncode != 0:
+                job.write(f"{now_hms()} [SKIP] precheck: nothing due")
+                metrics.record("skip", job.name, reason="precheck")
+                return
+        memo = {}
+        if job.fingerprint:
+            todo, memo = self.unchanged(job, job.action, job.fingerprint, [""])
+            if not todo:
+                job.write(f"{now_hms()} [SKIP] inputs unchanged since the last run")
+                metrics.record("skip", job.name, reason="unchanged")
+                return
+        try:
+            argv = resolve_argv([expand_now(a) for a in shlex.split(job.action)])
+        except ValueError:
+            argv = []
+        job.write("")
+        job.write(f"{now_hms()} [EXEC] {job.action}")
+        if not argv:
+            job.write(f"{now_hms()} [ERR] Action not executable: {job.action}")
+            return
+        self.remember(memo)
+        job.running.append((job.spawn(argv), time.time(), list(memo)))
+        self.stats["actions"] += 1
+        self.stats["forks"] += 1
+
+    def on_event(self, src: Source, path: str, flags: set):
+        self.stats["events"] += 1
+        if path.startswith(SKILLS_DIR + "/"):
+            # Skill files changed: refresh the doctor records soon
+            self.next_scan = min(self.next_scan, time.monotonic() + 1)
+        # A path that is gone (deleted, renamed away) only reaches watchers
+        # that listen for Removed, so their action can drop it
+        gone = not os.path.lexists(path)
+        if not gone and not os.path.isfile(path):
+            return
+        for w in src.watchers:
+            if gone and not w.removals:
+                continue
+            if not w.accepts(path, flags):
+                continue
+            if not path.startswith(w.root + "/"):
+                continue
+            rel_path = path[len(w.root) + 1:]
+            rules = w.candidate_rules(rel_path)
+            if not rules:
+                continue
+            # Conditions wait for the debounce: the first rule whose condition
+            # holds then wins, as if they had been checked in order here
+            self.stats["matched"] += 1
+            if self.pending.push((w.name, path), w.debounce, (w, path, rules)):
+                w.write(f"{now_hms()} [DETECT] {rel_path} (waiting {w.debounce:g}s...)")
+                self.detected.setdefault((w.name, path), time.monotonic())
+                metrics.record("trigger", w.name, kind=w.kind)
+            else:
+                w.write(f"{now_hms()} [UPDATE] {rel_path} (resetting timer...)")
+
+    def check_condition(self, condition: str, path: str) -> bool:
+        """Run condition on path, reusing the result while the content is unchanged."""
+        try:
+            st = os.stat(path)
+        except FileNotFoundError:
+            return False
+        key = (condition, path)
+        cached = self.condition_cache.get(key)
+        if cached and cached[:2] == (st.st_mtime_ns, st.st_size):
+            self.stats["conditions_cached"] += 1
+            return cached[3]
+        digest = None
+        try:
+            with open(path, "rb") as f:
+                digest = hashlib.sha1(f.read()).digest()
+        except OSError:
+            pass
+        if cached and digest is not None and cached[2] == digest:
+            passed = cached[3]
+            self.stats["conditions_cached"] += 1
+        else:
+            self.stats["conditions"] += 1
+            self.stats["forks"] += 1
+            result = subprocess.run(["bash", "-c", f'{condition} "$1"', "condition", path],
+                                    cwd=ZENIX_ROOT, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+            passed = result.returncode == 0
+        self.condition_cache.pop(key, None)
+        if len(self.condition_cache) >= CONDITION_CACHE_MAX:
+            del self.condition_cache[next(iter(self.condition_cache))]  # oldest entry
+        self.condition_cache[key] = (st.st_mtime_ns, st.st_size, digest, passed)
+        return passed
+
+    def check_pending(self):
+        for w, path, rules in self.pending.pop_due():
+            if not os.path.isfile(path) and (os.path.lexists(path) or not w.removals):
+                self.detected.pop((w.name, path), None)
+                continue
+            for rule in rules:  # Only first matching rule
+                if not rule.condition or self.check_condition(rule.condition, path):
+                    if rule.batch:
+                        since, paths, _ = w.held.setdefault(rule.action, (time.monotonic(), [], rule))
+                        if path not in paths:
+                            paths.append(path)
+                    else:
+                        w.ready.append(([path], rule))
+                    break
+            else:
+                w.write(f"{now_hms()} [SKIP] {path[len(w.root) + 1:]} (condition not met)")
+                self.detected.pop((w.name, path), None)
+                metrics.record("skip", w.name, reason="condition")
+        for w in self.watchers:
+            self.release_batches(w)
+            self.run_next(w)
+        if self.retired:
+            self.reap_retired()
+        self.check_cron()
+        if time.monotonic() >= self.next_scan:
+            self.scan()
+        for w in self.watchers + self.cron:
+            self.board.set(("w", w.name), self.watcher_row(w))
+
+    def watcher_row(self, w: Job) -> str:
+        last = f"{w.last_trigger or '-'} {w.last_exit if w.last_exit is not None else '-'} {w.last_ms} {w.triggers}"
+        if isinstance(w, CronJob):
+            return (f"w {w.name} cron active {int(w.fire_at)} {len(w.running)} {w.max_concurrent} "
+                    f"{last} {w.schedule.text}")
+        running = w.running.pid if w.running is not None and w.running.poll() is None else "-"
+        return f"w {w.name} fswatch running {self.pending.depth.get(w.name, 0)} {len(w.ready)} {running} {last}"
+
+    def scan(self):
+        """Rebuild the records not driven by events: skills and idle watchers."""
+        self.next_scan = time.monotonic() + SCAN_INTERVAL
+        loaded = {w.name: w for w in self.watchers + self.cron}
+        disabled = read_disabled()
+        rows = [("daemon", f"watcherd {os.getpid()} {self.started} {int(time.time())}")]
+        for yaml_file in sorted(glob.glob(os.path.join(SKILLS_DIR, "*", "*", "watchers", "*.yaml"))):
+            try:
+                cfg = load_yaml(yaml_file)
+            except (OSError, ValueError):
+                continue
+            name, kind = str(cfg.get("name") or ""), str(cfg.get("type") or "")
+            if not name or not kind or " " in name:
+                continue
+            if name in loaded:
+                rows.append((("w", name), self.watcher_row(loaded[name])))
+            else:
+                state = "disabled" if name in disabled else "stopped"
+                rows.append((("w", name), f"w {name} {kind} {state} - - - - - - -"))
+        for skill_md in sorted(glob.glob(os.path.join(SKILLS_DIR, "*", "*", "SKILL.md"))):
+            skill_dir = os.path.dirname(skill_md)
+            rows.append((("s", skill_dir), skill_row(skill_dir)))
+
+        if [key for key, _ in rows] != self.board.keys():
+            self.board.rebuild(rows)
+        else:
+            for key, text in rows:
+                self.board.set(key, text)
+        self.export_metrics()
+        self.rotate_logs()
+
+    def release_batches(self, w: Watcher):
+        """Hand held batch paths to one action once the watcher has nothing
+        else pending (the burst settled), or after one more debounce."""
+        if not w.held:
+            return
+        settled = self.pending.depth.get(w.name, 0) == 0
+        for action, (since, paths, rule) in list(w.held.items()):
+            if settled or time.monotonic() - since >= w.debounce:
+                del w.held[action]
+                w.ready.append((paths, rule))
+
+    # ── memoised actions ──
+
+    def unchanged(self, job: Job, action: str, fp: Fingerprint, paths: list) -> tuple:
+        """([paths whose inputs changed], {key: digest} to record when run)."""
+        todo, memo = [], {}
+        for path in paths:
+            key = f"{job.name}\t{action}\t{path}"
+            digest = fp.digest(path, self.stats)
+            if digest is not None and self.fingerprints.get(key) == digest:
+                self.stats["unchanged"] += 1
+                continue
+            todo.append(path)
+            if digest is not None:
+                memo[key] = digest
+        return todo, memo
+
+    def remember(self, memo: dict):
+        if memo:
+            self.fingerprints.update(memo)
+            save_fingerprints(self.fingerprints)
+
+    def forget(self, keys: list):
+        """Drop the fingerprints of a failed run, so the next trigger retries."""
+        if keys:
+            for key in keys:
+                self.fingerprints.pop(key, None)
+            save_fingerprints(self.fingerprints)
+
+    def duplicates(self, w: Watcher, argv: list, paths: list) -> tuple:
+        """([paths not run with argv by any watcher within w.dedup], their keys)."""
+        now = time.monotonic()
+        if len(self.recent) > 256:
+            horizon = max([DEDUP_WINDOW] + [x.dedup for x in self.watchers])
+            self.recent = {k: v for k, v in self.recent.items() if now - v[0] < horizon}
+        todo, keys = [], []
+        for path in paths:
+            try:
+                version = os.stat(path).st_mtime_ns
+            except OSError:
+                version = None
+            key = (tuple(argv), path, version)
+            seen = self.recent.get(key)
+            if w.dedup > 0 and seen and now - seen[0] < w.dedup:
+                self.stats["duplicates"] += 1
+                w.write(f"{now_hms()} [DEDUP] {path[len(w.root) + 1:]} "
+                        f"(already run by {seen[1]} {now - seen[0]:.0f}s ago)")
+                metrics.record("skip", w.name, reason="dedup")
+                continue
+            todo.append(path)
+            keys.append(key)
+        return todo, keys
+
+    def run_next(self, w: Watcher):
+        """Run the next ready action of a watcher (one at a time per watcher)."""
+        if w.running:
+            code = w.running.poll()
+            if code is None:
+                return
+            w.finished(code, w.started, w.run)
+            if code != 0:
+                self.forget(w.memo)
+        w.running = None
+        w.memo = []
+        while w.ready and w.running is None:
+            paths, rule = w.ready.pop(0)
+            action = rule.action
+            now = time.monotonic()
+            waited = [now - self.detected.pop((w.name, p), now) for p in paths]
+            argv = resolve_action(action)
+            keys, memo = [], {}
+            if argv:
+                paths, keys = self.duplicates(w, argv, paths)
+            if paths and rule.fingerprint:
+                todo, memo = self.unchanged(w, action, rule.fingerprint, paths)
+                for path in paths:
+                    if path not in todo:
+                        w.write(f"{now_hms()} [SKIP] {path[len(w.root) + 1:]} (inputs unchanged)")
+                        metrics.record("skip", w.name, reason="unchanged")
+                keys = [k for k in keys if k[1] in todo]
+                paths = todo
+            if not paths:
+                continue
+            w.write("")
+            if len(paths) == 1:
+                w.write(f"{now_hms()} [EXEC] Processing: {paths[0]}")
+            else:
+                w.write(f"{now_hms()} [EXEC] Processing {len(paths)} files (batch): {' '.join(paths)}")
+            w.write(f"{now_hms()} [EXEC] Action: {action}")
+            if not argv:
+                w.write(f"{now_hms()} [ERR] Action not executable: {action}")
+                continue
+            w.started = time.time()
+            w.run = {"act": os.path.basename(argv[0]), "wait": int(max(waited) * 1000),
+                     "files": len(paths)}
+            w.running = w.spawn(argv + paths)
+            now = time.monotonic()
+            for key in keys:
+                self.recent[key] = (now, w.name)
+            self.remember(memo)
+            w.memo = list(memo)
+            self.stats["actions"] += 1
+            self.stats["forks"] += 1
+
+    def write_stats(self):
+        tmp = STATS_FILE + ".tmp"
+        with open(tmp, "w") as f:
+            for name, value in self.stats.items():
+                f.write(f"{name} {value}\n")
+        os.replace(tmp, STATS_FILE)
+        self.export_metrics()
+
+    def rotate_logs(self):
+        """Archive logs past LOG_MAX / LOG_AGE whose watcher is idle, gzip them."""
+        self.compressing = [p for p in self.compressing if p.poll() is None]
+        archived = []
+        for job in self.watchers + self.cron:
+            if job.busy():
+                job.mark()  # keep the index fine-grained under long actions
+            elif job.rotate_due():
+                try:
+                    archived.append((job.name, job.rotate()))
+                except OSError as e:
+                    log(f"rotating {job.name}.log failed: {e}")
+        try:
+            # watcherd.log: stdout/stderr of this process (see watcher/run)
+            if os.fstat(1).st_ino == os.stat(DAEMON_LOG).st_ino and os.fstat(1).st_size > LOG_MAX:
+                base = archive_base("watcherd")
+                os.replace(DAEMON_LOG, base + ".log")
+                fd = os.open(DAEMON_LOG, os.O_WRONLY | os.O_APPEND | os.O_CREAT, 0o644)
+                os.dup2(fd, 1)
+                os.dup2(fd, 2)
+                os.close(fd)
+                archived.append(("watcherd", base + ".log"))
+        except OSError:
+            pass
+        for name, path in archived:
+            log(f"rotated {name}.log → archive/{os.path.basename(path)}.gz")
+            self.stats["forks"] += 1
+            self.compressing.append(subprocess.Popen(["gzip", "-f", path], stdin=subprocess.DEVNULL,
+                                                     stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL))
+            prune_archive(name)
+
+    def export_metrics(self):
+        """Rewrite the OpenMetrics textfile when new records were appended."""
+        try:
+            if self.metrics.refresh() or not os.path.exists(metrics.TEXTFILE):
+                metrics.write_textfile(self.metrics.tally)
+        except OSError as e:
+            log(f"metrics export failed: {e}")
+
+    def run(self):
+        # SIGCHLD wakes the loop so the next ready action starts at once
+        for sig in (signal.SIGHUP, signal.SIGUSR1, signal.SIGTERM, signal.SIGINT, signal.SIGCHLD):
+            signal.signal(sig, self._signal)
+        self.load()
+
+        while not self.stop_requested:
+            # Sleep until the next debounce deadline, cron run or board scan
+            timeout = max(0.0, self.next_scan - time.monotonic())
+            for t in (self.pending.timeout(), self.cron_timeout(), self.source_timeout()):
+                if t is not None:
+                    timeout = min(timeout, t)
+            for key, _ in self.sel.select(timeout=timeout):
+                if key.data is None:
+                    os.read(self.wake_r, 512)
+                    continue
+                src = key.data
+                for path, flags in src.read_events():
+                    self.on_event(src, path, flags)
+                if src.proc.poll() is not None:
+                    self.source_exited(src)
+            if self.reload_requested:
+                self.reload_requested = False
+                self.load()
+            self.restart_sources()
+            self.check_pending()
+            if self.stats_requested:
+                self.stats_requested = False
+                self.write_stats()
+
+        for s in self.sources:
+            s.stop()
+        for w in self.watchers + self.cron:
+            w.close_log()
+        self.board.close()
+        try:
+            os.remove(STATS_FILE)
+        except FileNotFoundError:
+            pass
+        log("stopped")
+
+
+def load_fingerprints() -> dict:
+    try:
+        with open(FINGERPRINT_FILE) as f:
+            data = json.load(f)
+        return data if isinstance(data, dict) else {}
+    except (OSError, ValueError):
+        return {}
+
+
+def save_fingerprints(fingerprints: dict):
+    os.makedirs(STATE_DIR, exist_ok=True)
+    tmp = FINGERPRINT_FILE + ".tmp"
+    with open(tmp, "w") as f:
+        json.dump(fingerprints, f, indent=0, sort_keys=True)
+    os.replace(tmp, FINGERPRINT_FILE)
+
+
+def resolve_action(action: str) -> list:
+    """Split an action into argv, resolving the script relative to ZENIX_ROOT."""
+    try:
+        return resolve_argv(shlex.split(action))
+    except ValueError:
+        return []
+
+
+def resolve_argv(argv: list) -> list:
+    """argv with its program resolved: ZENIX_ROOT-relative, else bin/ or PATH for a bare name."""
+    if not argv:
+        return []
+    prog = argv[0]
+    if not prog.startswith("/"):
+        candidates = [os.path.join(ZENIX_ROOT, prog)]
+        if "/" not in prog:
+            candidates += [os.path.join(ZENIX_ROOT, "bin", prog), shutil.which(prog) or ""]
+        prog = next((c for c in candidates if c and os.access(c, os.X_OK)), "")
+    if not prog or not os.access(prog, os.X_OK):
+        return []
+    return [prog] + argv[1:]
+
+
+def lock_singleton():
+    """Refuse to start a second daemon for the same state directory."""
+    os.makedirs(LOG_DIR, exist_ok=True)
+    fd = os.open(os.path.join(STATE_DIR, "watcherd.lock"), os.O_RDWR | os.O_CREAT, 0o644)
+    try:
+        fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+    except BlockingIOError:
+        print("watcherd is already running", file=sys.stderr)
+        sys.exit(1)
+    return fd
+
+
+def cmd_check():
+    for w in discover():
+        if isinstance(w, CronJob):
+            nxt = datetime.fromtimestamp(w.schedule.next_after(time.time()))
+            print(f"{w.name}: cron {w.schedule.text} (next {nxt:%Y-%m-%d %H:%M}) → {w.action}")
+            if w.precheck:
+                print(f"  precheck: {w.precheck}")
+            if w.fingerprint:
+                print(f"  fingerprint: {w.fingerprint.describe()}")
+            continue
+        dedup = f", dedup {w.dedup:g}s" if w.dedup > 0 else ""
+        print(f"{w.name}: {w.root} (debounce {w.debounce:g}s{dedup})")
+        for r in w.rules:
+            cond = f" if {r.condition}" if r.condition else ""
+            batch = " (batch)" if r.batch else ""
+            fp = f" (fingerprint: {r.fingerprint.describe()})" if r.fingerprint else ""
+            print(f"  {r.match.pattern} → {r.action}{batch}{fp}{cond}")
+
+
+def main():
+    args = sys.argv[1:]
+    if args == ["--check"]:
+        cmd_check()
+        return
+    if args:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+    _lock = lock_singleton()
+    os.environ["ZENIX_ROOT"] = ZENIX_ROOT  # actions like `zenix agent` need it
+    log(f"started (pid {os.getpid()}, root {ZENIX_ROOT})")
+    Daemon().run()
+
+
+if __name__ == "__main__":
+    main()
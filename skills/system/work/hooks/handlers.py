@@ -0,0 +1,125 @@
+"""In-process hook handlers (served by hook/scripts/hookd.py, see snapshot.sh)."""
+
+import os
+import re
+import subprocess
+import threading
+import time
+
+WORKSPACE_ROOT = os.path.expanduser("~/.workspace/")
+WORKSPACE_RE = re.compile(r"^\[[^]]+\]")
+
+# Edits to one workspace landing within QUIET seconds of each other share
+# one snapshot; a steady stream still gets one at least every MAX_DELAY.
+QUIET = 0.5
+MAX_DELAY = 2.0
+
+
+def fingerprint(path: str):
+    try:
+        st = os.stat(path)
+        return st.st_mtime_ns, st.st_size
+    except OSError:
+        return None
+
+
+class Snapshots:
+    """Coalesces snapshot requests per workspace into one `jj st`.
+
+    The handler only records the edited path and returns, so the tool call
+    never waits for a working copy walk. A background thread snapshots each
+    workspace once its edits go quiet, and skips it when every touched
+    path still has the mtime/size it had at the last snapshot. The thread
+    is started by an edit and exits once nothing is pending, so an instance
+    left behind by a hookd reload does not keep one. Pending snapshots lost
+    when the host stops are harmless: any jj command snapshots the working
+    copy itself.
+    """
+
+    def __init__(self):
+        self.cond = threading.Condition()
+        self.pending = {}  # workspace -> set of edited paths
+        self.first = {}    # workspace -> time of its oldest pending edit
+        self.last = {}     # workspace -> time of its latest edit
+        self.seen = {}     # workspace -> {path: fingerprint} at last snapshot
+        self.worker = None
+
+    def add(self, workspace: str, path: str):
+        with self.cond:
+            now = time.monotonic()
+            self.pending.setdefault(workspace, set()).add(path)
+            self.first.setdefault(workspace, now)
+            self.last[workspace] = now
+            if self.worker is None:
+                self.worker = threading.Thread(target=self.run, daemon=True)
+                self.worker.start()
+            self.cond.notify()
+
+    def take_due(self):
+        """Pop workspaces whose window closed; return (ready, seconds to next)."""
+        now = time.monotonic()
+        ready, wait = [], None
+        for workspace in list(self.pending):
+            due = min(self.last[workspace] + QUIET, self.first[workspace] + MAX_DELAY)
+            if due <= now:
+                ready.append((workspace, self.pending.pop(workspace)))
+                del self.first[workspace], self.last[workspace]
+            else:
+                wait = due - now if wait is None else min(wait, due - now)
+        return ready, wait
+
+    def run(self):
+        while True:
+            with self.cond:
+                ready, wait = self.take_due()
+                if not ready and wait is None:
+                    self.worker = None  # the next add starts another
+                    return
+                if not ready:
+                    self.cond.wait(wait)
+                    continue
+            for workspace, paths in ready:
+                self.snapshot(workspace, paths)
+
+    def snapshot(self, workspace: str, paths: set):
+        prints = {p: fingerprint(p) for p in paths}
+        seen = self.seen.setdefault(workspace, {})
+        if all(p in seen and seen[p] == fp for p, fp in prints.items()):
+            return
+        if not os.path.isdir(os.path.join(workspace, ".jj")):
+            return
+        # jj st triggers the working copy snapshot
+        try:
+            subprocess.run(["jj", "st"], cwd=workspace,
+                           stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        except FileNotFoundError:
+            return
+        seen.update(prints)
+
+
+SNAPSHOTS = Snapshots()
+
+
+def snapshot(event, ctx):
+    """Queue a workspace snapshot after an edit so jj log reflects it."""
+    file_path = (event.get("tool_input") or {}).get("file_path")
+    if not file_path:
+        return None
+    if not file_path.startswith("/"):
+        file_path = os.path.join(ctx.cwd, file_path)
+
+    # Only snapshot workspace directories (~/.workspace/[session-id])
+    if not file_path.startswith(WORKSPACE_ROOT):
+        return None
+    m = WORKSPACE_RE.match(file_path[len(WORKSPACE_ROOT):])
+    if not m:
+        return None
+    workspace = WORKSPACE_ROOT + m.group(0)
+    if not os.path.isdir(os.path.join(workspace, ".jj")):
+        return None
+
+    SNAPSHOTS.add(workspace, file_path)
+    return None
+
+
+HANDLERS = {"snapshot": snapshot}
@@ -1,6 +1,7 @@
 #!/usr/bin/env bash
 # PostToolUse hook: Snapshot workspace after edits
 # Ensures jj log reflects workspace changes immediately
+# (fallback: under the hook host, handlers.py batches these per workspace)
 set -eo pipefail
 
 INPUT=$(cat)
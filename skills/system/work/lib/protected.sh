@@ -1,10 +1,17 @@
 #!/usr/bin/env bash
 # protected.sh - [PROTECTED] buffer management
 # Source this file: source "$(dirname "$0")/../lib/protected.sh"
+#
+# ensure_protected reads everything it needs in one `jj log` and caches the
+# outcome keyed by the repo's operation id: while no jj operation happened
+# since the last check, it returns without running jj at all.
+
+PROTECTED_CACHE_DIR="${ZENIX_CACHE:-$HOME/.cache/zenix}/work"
 
 # Get the change ID of [PROTECTED] commit (empty if not found)
 get_protected_rev() {
-    jj log -r 'all()' --no-graph -T 'if(description.starts_with("[PROTECTED]"), change_id.short(), "")' 2>/dev/null | head -1
+    jj log -r 'description(substring:"[PROTECTED]")' --no-graph \
+        -T 'if(description.starts_with("[PROTECTED]"), change_id.short() ++ "\n")' 2>/dev/null | head -1
 }
 
 # Check if current @ is [PROTECTED]
@@ -13,35 +20,70 @@ is_protected() {
     [[ "$msg" == "[PROTECTED]"* ]]
 }
 
+# current_op_id <repo_root> - current operation id, read from the op heads
+# dir without forking jj (empty if the layout is not the expected one)
+current_op_id() {
+    local repo_dir="$1/.jj/repo" head op=""
+    # Secondary workspaces store the repo dir path in .jj/repo
+    [[ -f "$repo_dir" ]] && repo_dir=$(<"$repo_dir")
+    for head in "$repo_dir"/op_heads/heads/*; do
+        [[ -e "$head" ]] || continue
+        # Several heads mean concurrent ops jj has not merged yet
+        [[ -n "$op" ]] && return 0
+        op="${head##*/}"
+    done
+    echo "$op"
+}
+
 # Ensure [PROTECTED] exists, is a leaf of main, and default@ points to it
 # Call this from any work command to guarantee correct state
 ensure_protected() {
     local repo_root="${1:-$(jj root 2>/dev/null || pwd)}"
     cd "$repo_root"
 
-    local protected_rev=$(get_protected_rev)
+    local cache_file="$PROTECTED_CACHE_DIR/${repo_root//[^a-zA-Z0-9]/_}"
+    local op_id cached_op="" cached_rev=""
+    op_id=$(current_op_id "$repo_root")
+    [[ -f "$cache_file" ]] && read -r cached_op cached_rev < "$cache_file"
+    [[ -n "$op_id" && "$op_id" == "$cached_op" && -n "$cached_rev" ]] && return 0
+
+    # One pass: [PROTECTED], main and default@, each tagged with its roles
+    local protected_rev="" parent="" main_rev="" default_at=""
+    local change roles parents fixed=true
+    while IFS=$'\t' read -r change roles parents; do
+        [[ "$roles" == *P* && -z "$protected_rev" ]] && protected_rev="$change" && parent="$parents"
+        [[ "$roles" == *M* ]] && main_rev="$change"
+        [[ "$roles" == *D* ]] && default_at="$change"
+    done < <(jj log -r 'description(substring:"[PROTECTED]") | present(main) | present(default@)' --no-graph -T '
+        change_id.short() ++ "\t"
+        ++ if(description.starts_with("[PROTECTED]"), "P")
+        ++ if(self.contained_in("present(main)"), "M")
+        ++ if(self.contained_in("present(default@)"), "D")
+        ++ "\t" ++ parents.map(|c| c.change_id().short()).join(",") ++ "\n"' 2>/dev/null)
 
-    # 1. Create if missing
+    # 1. Create if missing (jj new leaves default@ on it)
     if [[ -z "$protected_rev" ]]; then
         echo "Creating [PROTECTED] buffer..." >&2
         jj new main -m "[PROTECTED] do not edit — use \`work on\`"
         protected_rev=$(jj log -r @ --no-graph -T 'change_id.short()')
-    else
-        # 2. Ensure it's a child of main (rebase if not)
-        local parent=$(jj log -r "${protected_rev}-" --no-graph -T 'change_id.short()' 2>/dev/null || echo "")
-        local main_rev=$(jj log -r main --no-graph -T 'change_id.short()' 2>/dev/null || echo "")
-
-        if [[ "$parent" != "$main_rev" ]]; then
-            echo "Rebasing [PROTECTED] to main..." >&2
-            jj rebase -r "$protected_rev" -d main 2>/dev/null || true
-        fi
+        default_at="$protected_rev"
+    # 2. Ensure it's a child of main (rebase if not)
+    elif [[ "$parent" != "$main_rev" ]]; then
+        echo "Rebasing [PROTECTED] to main..." >&2
+        jj rebase -r "$protected_rev" -d main 2>/dev/null || fixed=false
     fi
 
     # 3. Ensure default@ points to PROTECTED
-    local default_at=$(jj workspace list 2>/dev/null | grep "^default:" | awk '{print $2}')
-
     if [[ "$default_at" != "$protected_rev" ]]; then
         # Move default@ to PROTECTED
-        jj edit "$protected_rev" 2>/dev/null || true
+        jj edit "$protected_rev" 2>/dev/null || fixed=false
+    fi
+
+    # Fixes above are operations themselves: key the cache on the op after them
+    $fixed || return 0
+    op_id=$(current_op_id "$repo_root")
+    if [[ -n "$op_id" ]]; then
+        mkdir -p "$PROTECTED_CACHE_DIR"
+        echo "$op_id $protected_rev" > "$cache_file"
     fi
 }
@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+# workspace-pool.sh - Pre-provisioned jj workspaces claimed by dispatch.sh
+#
+# A pooled workspace is an ordinary $ZENIX_WORKSPACE/<prefix>-<hex> jj
+# workspace: already checked out, parked on an empty child of [PROTECTED]
+# (which jj rebases along with [PROTECTED] whenever main moves), with its
+# .repo_root written. What marks it as free is .jj/pooled, holding the repo
+# root; it lives in .jj/ so jj never snapshots it.
+#
+# Claiming renames the marker away, which is atomic: exactly one caller
+# wins each workspace. The claimer keeps the dir and its jj name as is,
+# so nothing has to be renamed or re-checked out.
+#
+# Usage:
+#   source "$ZENIX_ROOT/skills/system/work/lib/workspace-pool.sh"
+#   ws=$(work_pool_claim cc "$repo_root") && work_pool_refill cc "$repo_root"
+
+: "${ZENIX_WORKSPACE:=$HOME/.workspace}"
+_WORK_POOL_SCRIPT="${BASH_SOURCE[0]%/*}/../scripts/work-pool.sh"
+
+# work_pool_claim <prefix> <repo_root> - claim a free workspace, print its path
+work_pool_claim() {
+    local prefix="$1" repo_root="$2" marker ws
+    for marker in "$ZENIX_WORKSPACE/$prefix"-*/.jj/pooled; do
+        [[ -f "$marker" ]] || continue
+        [[ "$(<"$marker")" == "$repo_root" ]] || continue
+        ws="${marker%/.jj/pooled}"
+        # rename(2) is atomic: a concurrent claimer gets ENOENT and moves on
+        mv "$marker" "$ws/.jj/claimed.$$" 2>/dev/null || continue
+        rm -f "$ws/.jj/claimed.$$"
+        echo "$ws"
+        return 0
+    done
+    return 1
+}
+
+# work_pool_return <workspace> - mark an unused workspace free again
+work_pool_return() {
+    local ws="$1"
+    [[ -d "$ws/.jj" && -f "$ws/.repo_root" ]] || return 1
+    cp "$ws/.repo_root" "$ws/.jj/pooled"
+}
+
+# work_pool_refill <prefix> <repo_root> - top the pool up in the background
+work_pool_refill() {
+    nohup "$_WORK_POOL_SCRIPT" fill --prefix "$1" --repo "$2" >/dev/null 2>&1 &
+}
@@ -6,6 +6,11 @@
 #   --space    Clean empty workspace @ leaves (not default@)
 set -euo pipefail
 
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+source "$SCRIPT_DIR/../lib/protected.sh"
+source "$SCRIPT_DIR/../lib/workspace-pool.sh"
+source "$ZENIX_ROOT/skills/system/zenix/lib/config.sh"
+
 mode="${1:-}"
 
 # [PROTECTED] commits (never touch)
@@ -18,27 +23,58 @@ space_revset="heads(all()) & empty() & working_copies() ~ ($protected) ~ childre
 # Other: orphans that are not empty leaves, excluding [PROTECTED]
 other_revset="((~::bookmarks()) ~ (heads(all()) & empty())) ~ ($protected)"
 
-count_revset() {
-    jj log -r "$1" --no-graph -T '"x"' 2>/dev/null | wc -c | tr -d '[:space:]'
+# One jj log pass over every candidate, classified in the template with
+# contained_in() (the three sets are disjoint; [PROTECTED] is in none)
+q() { local r="${1//\\/\\\\}"; printf '%s' "${r//\"/\\\"}"; }
+classify_template='
+    if(self.contained_in("'"$(q "$safe_revset")"'"), "safe",
+    if(self.contained_in("'"$(q "$space_revset")"'"), "space", "other"))
+    ++ "\t" ++ commit_id ++ "\t" ++ if(working_copies, working_copies, "-")
+    ++ "\t" ++ change_id.short() ++ " " ++ commit_id.short()
+    ++ if(working_copies, " " ++ working_copies)
+    ++ " " ++ if(description, description.first_line(), "(no description set)") ++ "\n"'
+
+safe_count=0 space_count=0 other_count=0
+safe_lines="" space_lines="" other_lines=""
+space_commits="" space_workspaces=""
+# Free pooled workspaces (lib/workspace-pool.sh) are parked on purpose
+is_pooled() {
+    local wc
+    for wc in $1; do
+        [[ -f "$ZENIX_WORKSPACE/${wc%@}/.jj/pooled" ]] && return 0
+    done
+    return 1
 }
 
-show_revset() {
-    local label="$1" revset="$2" hint="$3"
-    local count=$(count_revset "$revset")
-    : "${count:=0}"
+while IFS=$'\t' read -r class commit_id working_copies line; do
+    [[ "$working_copies" != "-" ]] && is_pooled "$working_copies" && continue
+    case "$class" in
+        safe)
+            safe_count=$((safe_count + 1))
+            safe_lines+="$line"$'\n'
+            ;;
+        space)
+            space_count=$((space_count + 1))
+            space_lines+="$line"$'\n'
+            space_commits+="$commit_id "
+            [[ "$working_copies" != "-" ]] && space_workspaces+="$working_copies "
+            ;;
+        other)
+            other_count=$((other_count + 1))
+            other_lines+="$line"$'\n'
+            ;;
+    esac
+done < <(jj log -r "($safe_revset) | ($space_revset) | ($other_revset)" --no-graph -T "$classify_template" 2>/dev/null)
+
+show_class() {
+    local label="$1" count="$2" lines="$3" hint="$4"
     if [[ "$count" -gt 0 ]]; then
         echo "── $label ($count) ── [$hint]"
-        jj log -r "$revset" --no-graph
+        printf '%s' "$lines"
         echo ""
     fi
 }
 
-# Count categories
-safe_count=$(count_revset "$safe_revset")
-space_count=$(count_revset "$space_revset")
-other_count=$(count_revset "$other_revset")
-: "${safe_count:=0}" "${space_count:=0}" "${other_count:=0}"
-
 total=$((safe_count + space_count + other_count))
 
 if [[ "$total" -eq 0 ]]; then
@@ -57,24 +93,37 @@ case "$mode" in
         ;;
     --space)
         if [[ "$space_count" -gt 0 ]]; then
-            # Get list of workspace names and commit IDs that will be affected
-            workspaces=$(jj log -r "$space_revset" --no-graph -T 'if(working_copies, working_copies ++ "\n", "")' 2>/dev/null | grep -v '^$' | sort -u)
-            commit_ids=$(jj log -r "$space_revset" --no-graph -T 'commit_id ++ "\n"' 2>/dev/null | grep -v '^$')
+            # With a workspace pool, park leftover workspaces on [PROTECTED]
+            # and mark them free instead of forgetting them
+            config_load "$ZENIX_ROOT/skills/system/agent/config/provider.yaml" || true
+            config_read pool_size defaults.workspace_pool 0
+            protected_rev=""
+            [[ "$pool_size" =~ ^[1-9] ]] && protected_rev=$(get_protected_rev)
+            pooled_count=0
 
             # Forget each workspace (removes from jj, keeps directory)
-            for ws in $workspaces; do
+            for ws in $space_workspaces; do
                 ws_name="${ws%@}"  # Remove trailing @
-                if [[ "$ws_name" != "default" ]]; then
-                    jj workspace forget "$ws_name" 2>/dev/null || true
+                [[ "$ws_name" == "default" ]] && continue
+                ws_path="$ZENIX_WORKSPACE/$ws_name"
+                if [[ -n "$protected_rev" && -d "$ws_path/.jj" && -f "$ws_path/.repo_root" ]] &&
+                    (cd "$ws_path" && { jj workspace update-stale || true; } && jj new "$protected_rev") >/dev/null 2>&1; then
+                    work_pool_return "$ws_path"
+                    pooled_count=$((pooled_count + 1))
+                    continue
                 fi
+                jj workspace forget "$ws_name" 2>/dev/null || true
             done
 
             # Abandon the orphaned commits
-            for commit_id in $commit_ids; do
+            for commit_id in $space_commits; do
                 jj abandon "$commit_id" 2>/dev/null || true
             done
 
             echo "Cleaned $space_count workspace(s) - use 'work on' to reattach"
+            if [[ $pooled_count -gt 0 ]]; then
+                echo "Returned $pooled_count to the workspace pool"
+            fi
         else
             echo "Nothing to clean with --space"
         fi
@@ -83,9 +132,9 @@ case "$mode" in
         # Dry run - show what would be cleaned
         echo "Cleanable commits: $total"
         echo ""
-        show_revset "Safe" "$safe_revset" "--safe"
-        show_revset "Workspace" "$space_revset" "--space"
-        show_revset "Other" "$other_revset" "manual: jj abandon or jj rebase"
+        show_class "Safe" "$safe_count" "$safe_lines" "--safe"
+        show_class "Workspace" "$space_count" "$space_lines" "--space"
+        show_class "Other" "$other_count" "$other_lines" "manual: jj abandon or jj rebase"
         ;;
     *)
         echo "Usage: work clean [--safe | --space]" >&2
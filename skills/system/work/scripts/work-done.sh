@@ -47,6 +47,9 @@ jj bookmark set main -r @
 # Ensure [PROTECTED] exists, is leaf of main, default@ on it
 ensure_protected "$repo_root"
 
+# Pooled workspaces moved along with [PROTECTED]: update their files off-path
+nohup "$(dirname "$0")/work-pool.sh" refresh >/dev/null 2>&1 &
+
 # Move ws@ to merge (main)
 cd "$ws_path" && jj edit "$merge_rev"
 
@@ -0,0 +1,125 @@
+#!/usr/bin/env bash
+# work pool - Pre-provisioned workspaces for dispatch.sh (lib/workspace-pool.sh)
+# Usage:
+#   work pool fill [--repo <root>] [--prefix <p>] [--size N]
+#                        Create free workspaces up to the pool size
+#   work pool refresh    Update pooled workspaces left stale by a main move
+#   work pool status     Free workspaces per repo
+#   work pool drain      Forget and delete every free workspace
+#
+# Pool size: --size, else defaults.workspace_pool in agent provider.yaml
+# (0 = no pool). Prefix defaults to cc (claude-code), repo to `jj root`.
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+source "$SCRIPT_DIR/../lib/protected.sh"
+source "$SCRIPT_DIR/../lib/workspace-pool.sh"
+source "$ZENIX_ROOT/skills/system/zenix/lib/config.sh"
+
+LOCK_DIR="$ZENIX_ROOT/data/work"
+
+# All free workspaces, one path per line
+pooled() {
+    local marker
+    for marker in "$ZENIX_WORKSPACE"/*/.jj/pooled; do
+        [[ -f "$marker" ]] && echo "${marker%/.jj/pooled}"
+    done
+    return 0
+}
+
+cmd_fill() {
+    local repo_root="" prefix="cc" size=""
+    while [[ $# -gt 0 ]]; do
+        case "$1" in
+            --repo)   repo_root="$2"; shift 2 ;;
+            --prefix) prefix="$2"; shift 2 ;;
+            --size)   size="$2"; shift 2 ;;
+            *) echo "Unknown option: $1" >&2; exit 1 ;;
+        esac
+    done
+    [[ -z "$repo_root" ]] && repo_root=$(jj root 2>/dev/null || true)
+    if [[ -z "$repo_root" || ! -d "$repo_root/.jj" ]]; then
+        echo "Not a jj repo: ${repo_root:-$PWD}" >&2
+        exit 1
+    fi
+    if [[ -z "$size" ]]; then
+        config_load "$ZENIX_ROOT/skills/system/agent/config/provider.yaml" || true
+        config_read size defaults.workspace_pool 0
+    fi
+    [[ "$size" =~ ^[0-9]+$ && "$size" -gt 0 ]] || return 0
+
+    # One filler per prefix; a concurrent refill just skips
+    mkdir -p "$LOCK_DIR"
+    local lock="$LOCK_DIR/pool-$prefix.lock"
+    mkdir "$lock" 2>/dev/null || return 0
+    trap 'rmdir "$lock" 2>/dev/null || true' EXIT
+
+    local free=0 marker
+    for marker in "$ZENIX_WORKSPACE/$prefix"-*/.jj/pooled; do
+        [[ -f "$marker" && "$(<"$marker")" == "$repo_root" ]] && free=$((free + 1))
+    done
+
+    local protected_rev=""
+    if [[ $free -lt $size ]]; then
+        (ensure_protected "$repo_root") >/dev/null 2>&1 || true
+        protected_rev=$(cd "$repo_root" && get_protected_rev)
+    fi
+
+    while [[ $free -lt $size && -n "$protected_rev" ]]; do
+        local name="${prefix}-$(openssl rand -hex 4)"
+        local ws="$ZENIX_WORKSPACE/$name"
+        [[ -e "$ws" ]] && continue
+        mkdir -p "$ws"
+        echo "$repo_root" > "$ws/.repo_root"
+        # Checkout happens here, off the agent startup path
+        if ! (cd "$repo_root" && jj workspace add --name "$name" -r "$protected_rev" "$ws") >/dev/null 2>&1; then
+            rm -rf "$ws"
+            echo "Failed to create pooled workspace in $repo_root" >&2
+            break
+        fi
+        work_pool_return "$ws"
+        free=$((free + 1))
+    done
+    echo "$prefix: $free/$size free for $repo_root"
+}
+
+cmd_refresh() {
+    local ws
+    while IFS= read -r ws; do
+        # Parked on [PROTECTED]: a main move rebases it and leaves it stale
+        (cd "$ws" && jj workspace update-stale) >/dev/null 2>&1 || true
+    done < <(pooled)
+}
+
+cmd_status() {
+    local ws n=0
+    while IFS= read -r ws; do
+        echo "  ${ws##*/}  $(<"$ws/.jj/pooled")"
+        n=$((n + 1))
+    done < <(pooled)
+    echo "$n free workspace(s)"
+}
+
+cmd_drain() {
+    local ws n=0 repo_root
+    while IFS= read -r ws; do
+        # Claim first so dispatch cannot take it mid-drain
+        mv "$ws/.jj/pooled" "$ws/.jj/draining" 2>/dev/null || continue
+        repo_root=$(<"$ws/.jj/draining")
+        (cd "$repo_root" && jj workspace forget "${ws##*/}") >/dev/null 2>&1 || true
+        rm -rf "$ws"
+        n=$((n + 1))
+    done < <(pooled)
+    echo "Drained $n workspace(s)"
+}
+
+case "${1:-}" in
+    fill)    shift; cmd_fill "$@" ;;
+    refresh) cmd_refresh ;;
+    status)  cmd_status ;;
+    drain)   cmd_drain ;;
+    *)
+        echo "Usage: work pool <fill|refresh|status|drain>" >&2
+        exit 1
+        ;;
+esac
@@ -0,0 +1,69 @@
+#!/bin/bash
+# Cached yaml lookups for zenix scripts (see config_cache.py)
+#
+# Usage:
+#   source "$ZENIX_ROOT/skills/system/zenix/lib/config.sh"
+#   config_load "$CONFIG_FILE"                   # once per file
+#   config_read MODEL defaults.model opus        # MODEL=<value or fallback>
+#   config_get defaults.model opus               # same, printed
+#   jq '.' "$CONFIG_JSON"                        # parsed json of last load
+#
+# Lookups of a fresh cache never fork: the cache is a sourced file of flat
+# variables carrying its yaml's exact mtime, so `-nt` in either direction
+# means the yaml was replaced or edited. Only then does config_cache.py run,
+# which re-parses when the content hash changed.
+
+ZENIX_CACHE="${ZENIX_CACHE:-$HOME/.cache/zenix}"
+_CONFIG_LIB="${BASH_SOURCE[0]%/*}"
+
+CONFIG_NS=""
+CONFIG_JSON=""
+
+# config_load <yaml-file>
+# Loads (compiling if needed) and selects the file for config_read/config_get
+config_load() {
+    local file="$1"
+    [[ "$file" == /* ]] || file="$PWD/$file"
+
+    if [[ ! -f "$file" ]]; then
+        CONFIG_NS=""
+        CONFIG_JSON=""
+        return 1
+    fi
+
+    local id="${file//[^a-zA-Z0-9]/_}"
+    local cache="$ZENIX_CACHE/config/${id}.sh"
+    CONFIG_JSON="$ZENIX_CACHE/config/${id}.json"
+
+    if [[ "$file" -nt "$cache" || "$cache" -nt "$file" ||
+          "$file" -nt "$CONFIG_JSON" || "$CONFIG_JSON" -nt "$file" ]]; then
+        python3 "$_CONFIG_LIB/config_cache.py" compile "$file" >/dev/null || return 1
+    fi
+
+    # shellcheck disable=SC1090
+    source "$cache"
+    CONFIG_NS="zc${id}"
+}
+
+# config_read <var> <dotted.key> [fallback]
+# Lists of scalars read as newline-joined values; <key>.n is the length
+config_read() {
+    local __out="$1"
+    local __key="${2//./__}"
+    local __fallback="${3:-}"
+    local __var="${CONFIG_NS}__${__key//[^a-zA-Z0-9_]/_}"
+
+    if [[ -n "$CONFIG_NS" ]]; then
+        printf -v "$__out" '%s' "${!__var:-$__fallback}"
+    else
+        printf -v "$__out" '%s' "$__fallback"
+    fi
+}
+
+# config_get <dotted.key> [fallback]
+config_get() {
+    local value
+    config_read value "$@"
+    [[ -n "$value" ]] && echo "$value"
+    return 0
+}
@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+"""
+config_cache - Parse zenix yaml once into a cache keyed by mtime + content hash.
+
+Every yaml file compiles to two files under $ZENIX_CACHE/config/:
+
+    <id>.json   parsed data (for jq and python)
+    <id>.sh     flat shell assignments (for bash, sourced by lib/config.sh)
+
+<id> is the absolute path with every non-alphanumeric character replaced
+by "_", so bash can derive it without forking. <id>.sha1 holds the content
+hash and the yaml's stat (mtime_ns, size, inode) it was taken from: a cache
+is fresh while that stat is unchanged, and otherwise the hash decides
+whether to re-parse. Both cache files get the yaml's exact mtime, which is
+what lib/config.sh compares (`-nt` both ways, no fork), so an edit that
+keeps or restores an older mtime (cp -p, rsync, mv) is still seen. A yaml
+written within RACY_NS of its compile may be edited again in the same mtime
+tick, so its cache is left stale on purpose and re-hashed on the next load.
+
+Usage:
+    config_cache.py compile <yaml>...   Refresh caches, print .json paths
+    config_cache.py get <yaml> <key>    Print one value (dotted key path)
+
+Python callers:
+    sys.path.insert(0, "$ZENIX_ROOT/skills/system/zenix/lib")
+    import config_cache
+    data = config_cache.load(path)
+"""
+
+import hashlib
+import json
+import os
+import re
+import sys
+import time
+
+CACHE_DIR = os.path.join(
+    os.environ.get("ZENIX_CACHE", os.path.expanduser("~/.cache/zenix")), "config")
+
+RACY_NS = 2 * 10**9
+
+KEY_RE = re.compile(r"^([A-Za-z_][\w.-]*):(?:\s+(.*))?$")
+
+
+# ─────────────────────────────────────────────────────────────
+# Lenient yaml subset parser
+#
+# Covers what zenix config uses: nested maps by indentation, block and
+# inline lists, lists of maps, quoted scalars and trailing comments.
+# Intentionally lenient: watcher yaml uses "\.DS_Store", which strict
+# yaml rejects, and macOS has no PyYAML by default.
+# ─────────────────────────────────────────────────────────────
+
+def _scalar(value: str):
+    value = value.strip()
+    if value[:1] in ("'", '"'):
+        quote = value[0]
+        end = value.find(quote, 1)
+        if end > 0:
+            inner = value[1:end]
+            return inner.replace("\\\\", "\\") if quote == '"' else inner
+    if " #" in value:
+        value = value.split(" #", 1)[0].rstrip()
+    if value.startswith("[") and value.endswith("]"):
+        return [_scalar(v) for v in value[1:-1].split(",") if v.strip()]
+    if value in ("", "~", "null"):
+        return None
+    if value in ("true", "false"):
+        return value == "true"
+    if re.fullmatch(r"-?\d+", value):
+        return int(value)
+    if re.fullmatch(r"-?\d+\.\d+", value):
+        return float(value)
+    return value
+
+
+def _lines(text: str) -> list:
+    out = []
+    for raw in text.splitlines():
+        stripped = raw.strip()
+        if not stripped or stripped.startswith("#") or stripped == "---":
+            continue
+        out.append((len(raw) - len(raw.lstrip(" ")), stripped))
+    return out
+
+
+def _block(lines: list, i: int, indent: int):
+    """Parse the block starting at lines[i] with the given indent."""
+    if lines[i][1].startswith("- ") or lines[i][1] == "-":
+        return _list(lines, i, indent)
+    return _map(lines, i, indent)
+
+
+def _child(lines: list, i: int, indent: int):
+    """Value of an empty `key:` — a nested block, or None."""
+    if i < len(lines):
+        child_indent, text = lines[i]
+        if child_indent > indent or (child_indent == indent and text.startswith("- ")):
+            return _block(lines, i, child_indent)
+    return None, i
+
+
+def _map(lines: list, i: int, indent: int):
+    data: dict = {}
+    while i < len(lines) and lines[i][0] == indent and not lines[i][1].startswith("- "):
+        m = KEY_RE.match(lines[i][1])
+        i += 1
+        if not m:
+            continue
+        key, value = m.group(1), m.group(2)
+        if value:
+            data[key] = _scalar(value)
+        else:
+            data[key], i = _child(lines, i, indent)
+    return data, i
+
+
+def _list(lines: list, i: int, indent: int):
+    items: list = []
+    while i < len(lines) and lines[i][0] == indent and (lines[i][1].startswith("- ") or lines[i][1] == "-"):
+        body = lines[i][1][2:].strip()
+        i += 1
+        if not body:
+            value, i = _child(lines, i, indent)
+            items.append(value)
+            continue
+        m = KEY_RE.match(body)
+        if m and body[:1] not in ("'", '"'):
+            # List of maps: first key inline, the rest indented under it
+            item_indent = indent + 2
+            item = {}
+            key, value = m.group(1), m.group(2)
+            if value:
+                item[key] = _scalar(value)
+            else:
+                item[key], i = _child(lines, i, item_indent)
+            if i < len(lines) and lines[i][0] > indent:
+                rest, i = _map(lines, i, lines[i][0])
+                item.update(rest)
+            items.append(item)
+        else:
+            items.append(_scalar(body))
+    return items, i
+
+
+def parse(text: str):
+    lines = _lines(text)
+    if not lines:
+        return None
+    value, _ = _block(lines, 0, lines[0][0])
+    return value
+
+
+# ─────────────────────────────────────────────────────────────
+# Cache
+# ─────────────────────────────────────────────────────────────
+
+def cache_id(path: str) -> str:
+    return re.sub(r"[^A-Za-z0-9]", "_", path)
+
+
+def cache_paths(path: str) -> tuple:
+    base = os.path.join(CACHE_DIR, cache_id(path))
+    return base + ".json", base + ".sh", base + ".sha1"
+
+
+def shell_quote(value) -> str:
+    if isinstance(value, bool):
+        value = "true" if value else "false"
+    elif value is None:
+        value = ""
+    return "'" + str(value).replace("'", "'\\''") + "'"
+
+
+def flatten(data, ns: str, out: list):
+    """Emit NAME=value lines; dotted key paths become __-joined names."""
+    if isinstance(data, dict):
+        for key, value in data.items():
+            flatten(value, ns + "__" + re.sub(r"[^A-Za-z0-9_]", "_", str(key)), out)
+    elif isinstance(data, list):
+        out.append(f"{ns}__n={len(data)}")
+        scalars = [v for v in data if not isinstance(v, (dict, list))]
+        if len(scalars) == len(data):
+            out.append(f"{ns}=" + shell_quote("\n".join("" if v is None else str(v) for v in data)))
+        for idx, value in enumerate(data):
+            flatten(value, f"{ns}__{idx}", out)
+    else:
+        out.append(f"{ns}={shell_quote(data)}")
+
+
+def _write(path: str, content: str):
+    tmp = f"{path}.{os.getpid()}.tmp"
+    with open(tmp, "w") as f:
+        f.write(content)
+    os.replace(tmp, path)
+
+
+def compile_file(path: str) -> str:
+    """Ensure the cache for path is fresh; return the .json cache path."""
+    # Absolute paths are kept verbatim so the id matches what bash derives
+    if not os.path.isabs(path):
+        path = os.path.abspath(path)
+    json_path, sh_path, sha_path = cache_paths(path)
+    st = os.stat(path)
+    stamp = f"{st.st_mtime_ns} {st.st_size} {st.st_ino}"
+    try:
+        with open(sha_path) as f:
+            old_digest, _, old_stamp = f.read().strip().partition(" ")
+    except FileNotFoundError:
+        old_digest = old_stamp = ""
+    cached = os.path.exists(json_path) and os.path.exists(sh_path)
+    if cached and old_stamp == stamp:
+        return json_path
+
+    with open(path, "rb") as f:
+        raw = f.read()
+    digest = hashlib.sha1(raw).hexdigest()
+    if not cached or digest != old_digest:
+        os.makedirs(CACHE_DIR, exist_ok=True)
+        data = parse(raw.decode("utf-8", "replace"))
+        lines = [f"# Generated by config_cache.py from {path}"]
+        flatten(data, "zc" + cache_id(path), lines)
+        _write(json_path, json.dumps(data))
+        _write(sh_path, "\n".join(lines) + "\n")
+
+    # Racy: a second edit in this mtime tick would keep the stamp, so record
+    # none and give the caches an mtime bash sees as stale (a whole second
+    # off, for bash versions that compare seconds only)
+    racy = time.time_ns() - st.st_mtime_ns < RACY_NS
+    _write(sha_path, f"{digest} {'-' if racy else stamp}\n")
+    mtime = st.st_mtime_ns - (10**9 if racy else 0)
+    for p in (json_path, sh_path):
+        os.utime(p, ns=(mtime, mtime))
+    return json_path
+
+
+def load(path: str):
+    """Parsed data for a yaml file, from cache when fresh."""
+    with open(compile_file(path)) as f:
+        return json.load(f)
+
+
+def get(data, key: str, fallback=None):
+    for part in key.split("."):
+        if isinstance(data, dict) and part in data:
+            data = data[part]
+        elif isinstance(data, list) and part.isdigit() and int(part) < len(data):
+            data = data[int(part)]
+        else:
+            return fallback
+    return data
+
+
+def main():
+    if len(sys.argv) >= 3 and sys.argv[1] == "compile":
+        for path in sys.argv[2:]:
+            print(compile_file(path))
+    elif len(sys.argv) >= 4 and sys.argv[1] == "get":
+        value = get(load(sys.argv[2]), sys.argv[3])
+        if isinstance(value, (dict, list)):
+            print(json.dumps(value))
+        elif isinstance(value, bool):
+            print("true" if value else "false")
+        elif value is not None:
+            print(value)
+    else:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,114 @@
+#!/bin/bash
+# Cached skill env snapshots
+#
+# Usage:
+#   source "$ZENIX_ROOT/skills/system/zenix/lib/env.sh"
+#   env_load "$skill_dir/env"         # apply (compiles on first use / change)
+#   env_load_always                   # every env marked # @always
+#
+# A skill env is compiled once into $ZENIX_CACHE/env/<category>-<skill>.sh:
+# the exports, functions and aliases it defined, already resolved, so
+# applying it is plain assignments with no subshells. The snapshot's first
+# line rejects it (return 1) when the env file, or a file it names with
+# "# @depends <path>" (relative to the skill dir) in its header, is newer;
+# env_load then recompiles. A variable the env prepends/appends to (PATH)
+# is stored as that edit, not as its compile-time value.
+
+ZENIX_CACHE="${ZENIX_CACHE:-$HOME/.cache/zenix}"
+ZENIX_ENV_CACHE="$ZENIX_CACHE/env"
+
+# env_snapshot <var> <env-file> - snapshot path for an env file (no fork)
+env_snapshot() {
+    local __name="${2#"$ZENIX_ROOT"/skills/}"
+    __name="${__name%/env}"
+    printf -v "$1" '%s' "$ZENIX_ENV_CACHE/${__name//\//-}.sh"
+}
+
+# env_load <env-file>
+env_load() {
+    local env="$1" snap
+    [[ -f "$env" ]] || return 0
+    env_snapshot snap "$env"
+    # shellcheck disable=SC1090
+    source "$snap" 2>/dev/null && return 0
+    if env_compile "$env" "$snap"; then
+        source "$snap"
+    else
+        source "$env"
+    fi
+}
+
+# env_load_always - apply the snapshots of every # @always env
+env_load_always() {
+    local env
+    ZENIX_ENV_ALWAYS=1
+    for env in "$ZENIX_ROOT"/skills/*/*/env; do
+        env_load "$env"
+    done
+    unset ZENIX_ENV_ALWAYS
+}
+
+# Runs in a clean child bash: source the env, print what it changed
+_ENV_DIFF='
+__eb=" $(compgen -e | tr "\n" " ") "
+for __n in $__eb; do printf -v "__zb_$__n" "%s" "${!__n}"; done
+__fb=" $(compgen -A function | tr "\n" " ") "
+__ab=$(alias -p)
+
+source "$1" >/dev/null 2>&1 </dev/null
+
+for __n in $(compgen -e); do
+    case "$__n" in _|SHLVL|PWD|OLDPWD) continue ;; esac
+    __b="__zb_$__n" __v="${!__n}"
+    if [[ "$__eb" != *" $__n "* ]]; then
+        printf "export %s=%q\n" "$__n" "$__v"
+    elif [[ "$__v" != "${!__b}" ]]; then
+        __o="${!__b}"
+        if [[ -n "$__o" && "$__v" == *"$__o" ]]; then
+            printf "export %s=%q\"\$%s\"\n" "$__n" "${__v%"$__o"}" "$__n"
+        elif [[ -n "$__o" && "$__v" == "$__o"* ]]; then
+            printf "export %s=\"\$%s\"%q\n" "$__n" "$__n" "${__v#"$__o"}"
+        else
+            printf "export %s=%q\n" "$__n" "$__v"
+        fi
+    fi
+done
+for __n in $__eb; do
+    [[ -n "${!__n+x}" ]] || printf "unset %s\n" "$__n"
+done
+for __n in $(compgen -A function); do
+    [[ "$__fb" == *" $__n "* ]] || declare -f "$__n"
+done
+__nl="
+"
+while IFS= read -r __a; do
+    [[ "$__nl$__ab$__nl" == *"$__nl$__a$__nl"* ]] || printf "%s\n" "$__a"
+done < <(alias -p)
+'
+
+# env_compile <env-file> <snapshot>
+env_compile() {
+    local env="$1" snap="$2" dir="${1%/*}" line always=false
+    local guard="[[ $(printf '%q' "$env") -nt $(printf '%q' "$snap")"
+    while IFS= read -r line; do
+        case "$line" in
+            "# @always"*) always=true ;;
+            "# @depends "*)
+                line="${line#"# @depends "}"
+                [[ "$line" == /* ]] || line="$dir/$line"
+                guard+=" || $(printf '%q' "$line") -nt $(printf '%q' "$snap")"
+                ;;
+            "#"*|"") ;;
+            *) break ;;
+        esac
+    done < "$env"
+
+    mkdir -p "${snap%/*}" || return 1
+    {
+        echo "# env snapshot of ${env#"$ZENIX_ROOT"/} (lib/env.sh)"
+        echo "$guard ]] && return 1"
+        $always || echo '[[ "${ZENIX_ENV_ALWAYS:-}" == 1 ]] && return 0'
+        bash --noprofile --norc -c "$_ENV_DIFF" _ "$env"
+        echo "return 0"
+    } > "$snap.$$.tmp" && mv "$snap.$$.tmp" "$snap"
+}
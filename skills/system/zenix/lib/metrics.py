@@ -0,0 +1,330 @@
+"""
+metrics - Append-only run metrics for watcher actions and agent runs.
+
+Writers append one line per record to $ZENIX_METRICS_DIR/metrics.log
+(default ~/.local/state/zenix/metrics/):
+
+    <epoch> <event> <name> key=value ...
+
+    trigger <watcher>  kind=fswatch|cron
+    skip    <watcher>  reason=condition|unchanged|dedup|precheck|busy
+    action  <watcher>  kind= act=<script> exit= ms= wait=<debounce ms> files=
+    agent   <agent>    model= status=ok|error|timeout|ratelimit exit= ms=
+                       in= out= cache_read= cache_write= cost=<usd> watcher=
+
+Each record is one O_APPEND write, so concurrent writers never interleave.
+Past MAX_BYTES the log rotates to metrics.log.1 .. .KEEP; the generation
+that falls off is first folded into totals.json, so exported counters keep
+counting across rotations.
+
+Python callers:
+    sys.path.insert(0, "$ZENIX_ROOT/skills/system/zenix/lib")
+    import metrics
+    metrics.record("action", "vault-notes", act="submit.sh", exit=0, ms=1200)
+
+Reader keeps a Tally (counters, histograms) of totals.json plus every live
+generation and extends it from where it stopped; openmetrics() renders it
+as an OpenMetrics textfile (watcherd writes $ZENIX_METRICS_DIR/zenix.prom).
+"""
+
+import fcntl
+import json
+import os
+import time
+
+METRICS_DIR = os.environ.get("ZENIX_METRICS_DIR") or os.path.join(
+    os.environ.get("XDG_STATE_HOME") or os.path.expanduser("~/.local/state"), "zenix", "metrics")
+LOG_FILE = os.path.join(METRICS_DIR, "metrics.log")
+TOTALS_FILE = os.path.join(METRICS_DIR, "totals.json")
+LOCK_FILE = os.path.join(METRICS_DIR, "lock")
+TEXTFILE = os.path.join(METRICS_DIR, "zenix.prom")
+MAX_BYTES = int(os.environ.get("ZENIX_METRICS_MAX") or 4 * 1024 * 1024)
+KEEP = 3
+# Histogram upper bounds, seconds (debounce waits, actions, agent runs)
+BUCKETS = (0.1, 0.5, 1, 5, 15, 60, 300, 900, 3600)
+
+HELP = {
+    "zenix_watcher_triggers": "Watcher triggers (debounce started, cron slot fired)",
+    "zenix_watcher_skips": "Triggers that ran no action, by reason",
+    "zenix_watcher_actions": "Watcher actions run, by exit code",
+    "zenix_watcher_action_duration_seconds": "Watcher action wall time",
+    "zenix_watcher_debounce_wait_seconds": "First event to action start",
+    "zenix_agent_runs": "Headless agent attempts, by outcome",
+    "zenix_agent_duration_seconds": "Headless agent attempt wall time",
+    "zenix_agent_tokens": "Agent tokens, by type",
+    "zenix_agent_cost_usd": "Agent cost from provider.yaml prices",
+}
+
+
+# ─────────────────────────────────────────────────────────────
+# Writing
+# ─────────────────────────────────────────────────────────────
+
+def record(event: str, name: str, **fields):
+    """Append one record; never raises (metrics must not break a run)."""
+    parts = [str(int(time.time())), event, clean(name) or "-"]
+    parts += [f"{k}={clean(v)}" for k, v in fields.items() if v is not None and v != ""]
+    line = (" ".join(parts) + "\n").encode()
+    try:
+        os.makedirs(METRICS_DIR, exist_ok=True)
+        fd = os.open(LOG_FILE, os.O_WRONLY | os.O_APPEND | os.O_CREAT, 0o644)
+        try:
+            os.write(fd, line)
+            size = os.fstat(fd).st_size
+        finally:
+            os.close(fd)
+        if size > MAX_BYTES:
+            rotate()
+    except OSError:
+        pass
+
+
+def clean(value) -> str:
+    if isinstance(value, float):
+        value = f"{value:.6f}".rstrip("0").rstrip(".")
+    return "".join(c if c.isprintable() and c not in " =" else "_" for c in str(value))
+
+
+def rotate():
+    """metrics.log → .1 → ... → .KEEP; the oldest is folded into totals.json."""
+    with open(LOCK_FILE, "w") as lock:
+        fcntl.flock(lock, fcntl.LOCK_EX)
+        try:
+            if os.path.getsize(LOG_FILE) <= MAX_BYTES:
+                return  # another writer rotated first
+        except OSError:
+            return
+        oldest = f"{LOG_FILE}.{KEEP}"
+        if os.path.exists(oldest):
+            tally = load_totals()
+            with open(oldest, "rb") as f:
+                for line in f:
+                    tally.add(parse(line))
+            save_totals(tally)
+        for i in range(KEEP, 0, -1):
+            src = f"{LOG_FILE}.{i - 1}" if i > 1 else LOG_FILE
+            if os.path.exists(src):
+                os.replace(src, f"{LOG_FILE}.{i}")
+
+
+# ─────────────────────────────────────────────────────────────
+# Reading
+# ─────────────────────────────────────────────────────────────
+
+def parse(line: bytes):
+    """(epoch, event, name, {field: str}) or None."""
+    parts = line.decode("utf-8", "replace").split()
+    if len(parts) < 3 or not parts[0].isdigit():
+        return None
+    fields = dict(p.split("=", 1) for p in parts[3:] if "=" in p)
+    return int(parts[0]), parts[1], parts[2], fields
+
+
+def generations() -> list:
+    """Log files, oldest first."""
+    files = [f"{LOG_FILE}.{i}" for i in range(KEEP, 0, -1)] + [LOG_FILE]
+    return [f for f in files if os.path.exists(f)]
+
+
+def records(since: int = 0):
+    """Every record at or after since, oldest first."""
+    for path in generations():
+        try:
+            with open(path, "rb") as f:
+                for line in f:
+                    rec = parse(line)
+                    if rec and rec[0] >= since:
+                        yield rec
+        except OSError:
+            continue
+
+
+def number(fields: dict, key: str) -> float:
+    try:
+        return float(fields.get(key) or 0)
+    except ValueError:
+        return 0.0
+
+
+class Tally:
+    """Counters and histograms derived from records ({series: value})."""
+
+    def __init__(self, data: dict = None):
+        data = data or {}
+        # "metric\tlabel=value,..." → float / [bucket counts..., count, sum]
+        self.counters: dict = data.get("counters") or {}
+        self.hists: dict = data.get("hists") or {}
+
+    def count(self, metric: str, labels: tuple, value: float = 1):
+        key = series(metric, labels)
+        self.counters[key] = self.counters.get(key, 0) + value
+
+    def observe(self, metric: str, labels: tuple, seconds: float):
+        key = series(metric, labels)
+        h = self.hists.get(key)
+        if h is None:
+            h = self.hists[key] = [0] * (len(BUCKETS) + 2)
+        for i, bound in enumerate(BUCKETS):
+            if seconds <= bound:
+                h[i] += 1
+        h[-2] += 1
+        h[-1] += seconds
+
+    def add(self, rec):
+        if rec is None:
+            return
+        _, event, name, f = rec
+        if event == "trigger":
+            self.count("zenix_watcher_triggers", (("watcher", name), ("kind", f.get("kind", ""))))
+        elif event == "skip":
+            self.count("zenix_watcher_skips", (("watcher", name), ("reason", f.get("reason", ""))))
+        elif event == "action":
+            w = ("watcher", name)
+            self.count("zenix_watcher_actions", (w, ("action", f.get("act", "")), ("exit", f.get("exit", ""))))
+            self.observe("zenix_watcher_action_duration_seconds", (w,), number(f, "ms") / 1000)
+            if "wait" in f:
+                self.observe("zenix_watcher_debounce_wait_seconds", (w,), number(f, "wait") / 1000)
+        elif event == "agent":
+            labels = (("agent", name), ("model", f.get("model", "")))
+            self.count("zenix_agent_runs", labels + (("status", f.get("status", "")),))
+            self.observe("zenix_agent_duration_seconds", labels, number(f, "ms") / 1000)
+            for key in ("in", "out", "cache_read", "cache_write"):
+                if number(f, key):
+                    self.count("zenix_agent_tokens", labels + (("type", key),), number(f, key))
+            if number(f, "cost"):
+                self.count("zenix_agent_cost_usd", labels + (("watcher", f.get("watcher", "-")),),
+                           number(f, "cost"))
+
+    def to_json(self) -> dict:
+        return {"counters": self.counters, "hists": self.hists}
+
+
+def series(metric: str, labels: tuple) -> str:
+    return metric + "\t" + ",".join(f"{k}={v}" for k, v in labels)
+
+
+def load_totals() -> Tally:
+    try:
+        with open(TOTALS_FILE) as f:
+            return Tally(json.load(f))
+    except (OSError, ValueError):
+        return Tally()
+
+
+def save_totals(tally: Tally):
+    tmp = f"{TOTALS_FILE}.{os.getpid()}.tmp"
+    with open(tmp, "w") as f:
+        json.dump(tally.to_json(), f, sort_keys=True)
+    os.replace(tmp, TOTALS_FILE)
+
+
+class Reader:
+    """Tally of everything recorded, extended incrementally.
+
+    Only the new complete lines of metrics.log are read on refresh; after a
+    rotation (new inode) the tally is rebuilt from totals.json and the
+    generations, under the rotation lock so nothing is counted twice.
+    """
+
+    def __init__(self):
+        self.tally = Tally()
+        self.ino = None
+        self.offset = 0
+
+    def refresh(self) -> bool:
+        """True if the tally changed."""
+        try:
+            st = os.stat(LOG_FILE)
+        except OSError:
+            return False
+        if st.st_ino != self.ino or st.st_size < self.offset:
+            self.rebuild()
+            return True
+        if st.st_size == self.offset:
+            return False
+        return self.read_from(LOG_FILE, self.offset) > 0
+
+    def rebuild(self):
+        os.makedirs(METRICS_DIR, exist_ok=True)
+        with open(LOCK_FILE, "w") as lock:
+            fcntl.flock(lock, fcntl.LOCK_SH)
+            self.tally = load_totals()
+            for path in generations()[:-1]:
+                self.read_from(path, 0)
+            try:
+                self.ino = os.stat(LOG_FILE).st_ino
+            except OSError:
+                self.ino = None
+            self.offset = 0
+            self.read_from(LOG_FILE, 0)
+
+    def read_from(self, path: str, offset: int) -> int:
+        """Add the complete lines of path after offset; returns bytes read."""
+        try:
+            with open(path, "rb") as f:
+                f.seek(offset)
+                data = f.read()
+        except OSError:
+            return 0
+        end = data.rfind(b"\n") + 1
+        for line in data[:end].splitlines():
+            self.tally.add(parse(line))
+        if path == LOG_FILE:
+            self.offset = offset + end
+        return end
+
+
+# ─────────────────────────────────────────────────────────────
+# OpenMetrics
+# ─────────────────────────────────────────────────────────────
+
+def _labels(text: str, extra: str = "") -> str:
+    pairs = [p.split("=", 1) for p in text.split(",") if p]
+    body = ",".join(f'{k}="{escape(v)}"' for k, v in pairs)
+    if extra:
+        body = f"{body},{extra}" if body else extra
+    return "{" + body + "}" if body else ""
+
+
+def escape(value: str) -> str:
+    return value.replace("\\", "\\\\").replace('"', '\\"').replace("\n", "\\n")
+
+
+INF = 'le="+Inf"'
+
+
+def openmetrics(tally: Tally) -> str:
+    by_metric: dict = {}
+    for key, value in tally.counters.items():
+        metric, labels = key.split("\t", 1)
+        by_metric.setdefault(metric, ("counter", []))[1].append((labels, value))
+    for key, value in tally.hists.items():
+        metric, labels = key.split("\t", 1)
+        by_metric.setdefault(metric, ("histogram", []))[1].append((labels, value))
+
+    out = []
+    for metric in sorted(by_metric):
+        kind, samples = by_metric[metric]
+        out.append(f"# TYPE {metric} {kind}")
+        if metric in HELP:
+            out.append(f"# HELP {metric} {HELP[metric]}")
+        for labels, value in sorted(samples):
+            if kind == "counter":
+                out.append(f"{metric}_total{_labels(labels)} {clean(float(value))}")
+                continue
+            for bound, n in zip(BUCKETS, value):
+                le = 'le="%g"' % bound
+                out.append(f"{metric}_bucket{_labels(labels, le)} {n}")
+            out.append(f"{metric}_bucket{_labels(labels, INF)} {value[-2]}")
+            out.append(f"{metric}_count{_labels(labels)} {value[-2]}")
+            out.append(f"{metric}_sum{_labels(labels)} {value[-1]:.3f}")
+    out.append("# EOF")
+    return "\n".join(out) + "\n"
+
+
+def write_textfile(tally: Tally, path: str = TEXTFILE):
+    os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+    tmp = f"{path}.{os.getpid()}.tmp"
+    with open(tmp, "w") as f:
+        f.write(openmetrics(tally))
+    os.replace(tmp, path)
@@ -0,0 +1,61 @@
+#!/bin/bash
+# Skill index lookups (see scripts/skill-index.py)
+#
+# Usage:
+#   source "$ZENIX_ROOT/skills/system/zenix/lib/skill-index.sh"
+#   skill_index_load                  # once; rebuilds if missing or stale
+#   skill_lookup RUN work run         # RUN=<field of skill "work">
+#   agent_lookup PATH executor path   # PATH=<field of agent "executor">
+#
+# Skill fields: category dir run env desc. Agent fields: skill path desc pool.
+# $ZENIX_SKILL_NAMES / $ZENIX_AGENT_NAMES list every name in index order.
+#
+# The watcher (watchers/skill-index.yaml) keeps the index fresh per skill.
+# Adding or removing a skill dir also bumps its category dir mtime, which
+# is checked here without forking.
+
+ZENIX_CACHE="${ZENIX_CACHE:-$HOME/.cache/zenix}"
+SKILL_INDEX="$ZENIX_CACHE/skills.sh"
+_SKILL_INDEX_BUILD="${BASH_SOURCE[0]%/*}/../scripts/skill-index.py"
+
+ZENIX_SKILL_NAMES=""
+ZENIX_AGENT_NAMES=""
+
+skill_index_load() {
+    local stale=false category
+    if [[ ! -f "$SKILL_INDEX" ]]; then
+        stale=true
+    else
+        for category in "$ZENIX_ROOT/skills"/*/; do
+            [[ "$category" -nt "$SKILL_INDEX" ]] && stale=true && break
+        done
+    fi
+
+    if $stale; then
+        python3 "$_SKILL_INDEX_BUILD" build >/dev/null 2>&1 || true
+    fi
+
+    # shellcheck disable=SC1090
+    [[ -f "$SKILL_INDEX" ]] && source "$SKILL_INDEX"
+    return 0
+}
+
+# skill_index_refresh - force a full rebuild (e.g. after an index miss)
+skill_index_refresh() {
+    python3 "$_SKILL_INDEX_BUILD" build >/dev/null 2>&1 || true
+    # shellcheck disable=SC1090
+    [[ -f "$SKILL_INDEX" ]] && source "$SKILL_INDEX"
+    return 0
+}
+
+# skill_lookup <var> <skill> <field>
+skill_lookup() {
+    local __var="zs_${2//[^a-zA-Z0-9]/_}_$3"
+    printf -v "$1" '%s' "${!__var:-}"
+}
+
+# agent_lookup <var> <agent> <field>
+agent_lookup() {
+    local __var="za_${2//[^a-zA-Z0-9]/_}_$3"
+    printf -v "$1" '%s' "${!__var:-}"
+}
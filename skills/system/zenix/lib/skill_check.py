@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""
+skill_check - The checks of `zenix doctor` (check_skill in zenix/run), in Python.
+
+watcherd runs these on its own schedule and publishes the results on its
+status board, so `zenix doctor` can print them without probing the tree.
+Keep the two in step: same checks, same messages.
+
+    import skill_check
+    skill_check.check("/path/to/skills/core/vault")
+    → [("ok", "SKILL.md"), ("ok", "frontmatter (name, description)"), ...]
+"""
+
+import glob
+import os
+import re
+
+
+def _frontmatter(path: str) -> list:
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+    if not text.startswith("---"):
+        return [("warn", "missing frontmatter")]
+    if re.search(r"^name:", text, re.M) and re.search(r"^description:", text, re.M):
+        return [("ok", "frontmatter (name, description)")]
+    return [("warn", "frontmatter missing name or description")]
+
+
+def check(skill_dir: str) -> list:
+    """[(level, message)] with level ok / warn / err, in doctor order."""
+    items = []
+    skill_md = os.path.join(skill_dir, "SKILL.md")
+    if os.path.isfile(skill_md):
+        items.append(("ok", "SKILL.md"))
+        items += _frontmatter(skill_md)
+    else:
+        items.append(("err", "SKILL.md missing"))
+
+    run = os.path.join(skill_dir, "run")
+    if os.path.isfile(run):
+        items.append(("ok", "run executable") if os.access(run, os.X_OK) else ("err", "run not executable"))
+
+    for yaml in sorted(glob.glob(os.path.join(skill_dir, "watch", "*.yaml"))):
+        name = os.path.basename(yaml)
+        with open(yaml, encoding="utf-8", errors="replace") as f:
+            text = f.read()
+        if re.search(r"^name:", text, re.M) and re.search(r"^type:", text, re.M):
+            items.append(("ok", f"watch/{name}"))
+        else:
+            items.append(("err", f"watch/{name} missing name or type"))
+
+    data = os.path.join(skill_dir, "data")
+    if os.path.islink(data):
+        items.append(("ok", "data symlink") if os.path.isdir(data) else ("err", "data symlink broken"))
+
+    for hook in sorted(glob.glob(os.path.join(skill_dir, "hooks", "*.sh"))):
+        name = os.path.basename(hook)
+        if os.access(hook, os.X_OK):
+            items.append(("ok", f"hooks/{name}"))
+        else:
+            items.append(("err", f"hooks/{name} not executable"))
+    return items
+
+
+def issues(items: list) -> int:
+    return sum(1 for level, _ in items if level != "ok")
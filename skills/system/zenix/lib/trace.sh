@@ -0,0 +1,55 @@
+#!/bin/bash
+# Opt-in startup tracing for the zenix → agent → dispatch → framework chain
+#
+# Usage:
+#   source "$ZENIX_ROOT/skills/system/zenix/lib/trace.sh"
+#   trace_mark agent.frontmatter     # the step named here just finished
+#
+# With ZENIX_TRACE=1 every mark appends one span to $ZENIX_TRACE_FILE
+# (JSONL, default ~/.local/state/zenix/trace.jsonl):
+#
+#   {"run":"<id>","cmd":"zenix agent -A heartbeat","stage":"agent.frontmatter","start":<s>,"end":<s>,"pid":<pid>}
+#
+# A span runs from the previous mark to this one. The previous mark and the
+# run id travel in the environment, so spans continue across exec: the first
+# span of each script includes its interpreter startup. Read with `zenix trace`.
+#
+# Times are EPOCHREALTIME (µs, read without forking; bash 5). Bash 3.2 falls
+# back to perl, which costs a fork per mark. Without ZENIX_TRACE=1,
+# trace_mark is a no-op.
+
+if [[ "${ZENIX_TRACE:-}" != "1" ]]; then
+    trace_mark() { :; }
+    return 0
+fi
+
+ZENIX_TRACE_FILE="${ZENIX_TRACE_FILE:-${XDG_STATE_HOME:-$HOME/.local/state}/zenix/trace.jsonl}"
+
+_trace_now() {
+    if [[ -n "${EPOCHREALTIME:-}" ]]; then
+        printf -v "$1" '%s' "${EPOCHREALTIME/,/.}"
+    else
+        printf -v "$1" '%s' "$(perl -MTime::HiRes=time -e 'printf "%.6f", time')"
+    fi
+}
+
+# First traced script of a run: start the clock and name the run
+if [[ -z "${ZENIX_TRACE_RUN:-}" ]]; then
+    _trace_now ZENIX_TRACE_LAST
+    ZENIX_TRACE_RUN="${ZENIX_TRACE_LAST%.*}-$$"
+    ZENIX_TRACE_CMD="${0##*/} ${1:-} ${2:-} ${3:-}"
+    ZENIX_TRACE_CMD="${ZENIX_TRACE_CMD//[\"\\[:cntrl:]]/}"
+    ZENIX_TRACE_CMD="${ZENIX_TRACE_CMD%"${ZENIX_TRACE_CMD##*[! ]}"}"
+    export ZENIX_TRACE_RUN ZENIX_TRACE_CMD ZENIX_TRACE_LAST
+    mkdir -p "${ZENIX_TRACE_FILE%/*}"
+fi
+
+# trace_mark <stage>
+trace_mark() {
+    local now
+    _trace_now now
+    printf '{"run":"%s","cmd":"%s","stage":"%s","start":%s,"end":%s,"pid":%s}\n' \
+        "$ZENIX_TRACE_RUN" "$ZENIX_TRACE_CMD" "$1" "$ZENIX_TRACE_LAST" "$now" "$$" \
+        >> "$ZENIX_TRACE_FILE"
+    export ZENIX_TRACE_LAST="$now"
+}
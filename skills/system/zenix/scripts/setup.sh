@@ -9,6 +9,13 @@ PROJECT_DIR="$ZENIX_ROOT"
 
 source "$ZENIX_DIR/lib/output.sh"
 
+DEPS=(fswatch yq)
+# Bare mirrors of the submodule repos; later setups (new worktree, reinstall)
+# fetch only what changed and clone locally
+MIRROR_DIR="${ZENIX_CACHE:-$HOME/.cache/zenix}/mirrors"
+SETUP_JOBS="${SETUP_JOBS:-8}"
+SETUP_LOGS="${ZENIX_CACHE:-$HOME/.cache/zenix}/setup"
+
 show_help() {
     cat <<'HELP'
 setup - Install and configure zenix
@@ -17,6 +24,10 @@ USAGE:
     setup                 Show installation status
     setup all             Install everything
     setup deps            Install brew dependencies (fswatch, yq)
+    setup submodules [--all] [--jobs N]
+                          Shallow-init core skill submodules in parallel
+                          (--all: community skills too)
+    setup fetch <skill>   Init one skill submodule (done lazily by zenix <skill>)
     setup shell           Add env.sh to ~/.zshrc
     setup git-hooks       Set core.hooksPath (works in worktrees)
     setup claude-hooks    Symlink .claude/hooks → hooks/claude
@@ -25,6 +36,7 @@ USAGE:
 
 COMPONENTS:
     deps          fswatch, yq (via Homebrew)
+    submodules    skills/core/* now; skills/community/* on first use
     shell         source env.sh in ~/.zshrc
     git-hooks     post-commit, post-merge logging
     claude-hooks  session-start, session-end, main-branch-guard
@@ -35,11 +47,94 @@ HELP
 # ============================================================
 # Status checks
 # ============================================================
+# missing_deps - names of DEPS not on PATH, one pass
+MISSING_DEPS=()
+missing_deps() {
+    local dep
+    MISSING_DEPS=()
+    for dep in "${DEPS[@]}"; do
+        command -v "$dep" >/dev/null 2>&1 || MISSING_DEPS+=("$dep")
+    done
+}
+
 check_deps() {
-    local missing=0
-    command -v fswatch >/dev/null 2>&1 || { missing=1; }
-    command -v yq >/dev/null 2>&1 || { missing=$((missing + 1)); }
-    [ $missing -eq 0 ]
+    missing_deps
+    [ ${#MISSING_DEPS[@]} -eq 0 ]
+}
+
+# ============================================================
+# Submodules
+# ============================================================
+
+# Parallel arrays from .gitmodules (one git call): SUB_PATHS, SUB_URLS
+SUB_PATHS=()
+SUB_URLS=()
+load_submodules() {
+    local key value name names=()
+    SUB_PATHS=()
+    SUB_URLS=()
+    [ -f "$PROJECT_DIR/.gitmodules" ] || return 0
+    while read -r key value; do
+        name="${key#submodule.}"
+        case "$key" in
+            *.path) names+=("${name%.path}"); SUB_PATHS+=("$value"); SUB_URLS+=("") ;;
+            *.url)
+                local i
+                for i in "${!names[@]}"; do
+                    [ "${names[$i]}" = "${name%.url}" ] && SUB_URLS[$i]="$value"
+                done
+                ;;
+        esac
+    done < <(git config -f "$PROJECT_DIR/.gitmodules" --get-regexp '^submodule\..*\.(path|url)$')
+}
+
+submodule_ready() {
+    [ -f "$PROJECT_DIR/$1/SKILL.md" ]
+}
+
+mirror_path() {
+    local repo="${1##*/}"
+    echo "$MIRROR_DIR/${repo%.git}.git"
+}
+
+# mirror_sync <url> - create or refresh the bare mirror of one repo
+mirror_sync() {
+    local url="$1" mirror
+    mirror=$(mirror_path "$url")
+    if [ -d "$mirror" ]; then
+        git -C "$mirror" fetch --prune --quiet
+    else
+        git clone --mirror --quiet "$url" "$mirror.tmp.$$" &&
+            git -C "$mirror.tmp.$$" config uploadpack.allowAnySHA1InWant true &&
+            mv "$mirror.tmp.$$" "$mirror"
+    fi
+}
+
+# init_submodules <path>... - mirrors in parallel, then one shallow update
+init_submodules() {
+    local paths=("$@") i j n=0 url
+    local rewrites=(-c protocol.file.allow=always)
+    [ ${#paths[@]} -gt 0 ] || return 0
+    mkdir -p "$MIRROR_DIR" "$SETUP_LOGS"
+
+    for i in "${!SUB_PATHS[@]}"; do
+        for j in "${paths[@]}"; do
+            [ "$j" = "${SUB_PATHS[$i]}" ] || continue
+            url="${SUB_URLS[$i]}"
+            mirror_sync "$url" > "$SETUP_LOGS/mirror-${url##*/}.log" 2>&1 &
+            n=$((n + 1))
+            [ $((n % SETUP_JOBS)) -eq 0 ] && wait
+        done
+    done
+    wait
+
+    # Clone from the local mirrors where they exist (file:// keeps --depth)
+    for i in "${!SUB_PATHS[@]}"; do
+        url="${SUB_URLS[$i]}"
+        [ -d "$(mirror_path "$url")" ] && rewrites+=(-c "url.file://$(mirror_path "$url").insteadOf=$url")
+    done
+    git "${rewrites[@]}" -C "$PROJECT_DIR" submodule update --init --depth 1 \
+        --jobs "$SETUP_JOBS" -- "${paths[@]}"
 }
 
 check_shell() {
@@ -66,9 +161,29 @@ show_status() {
     echo ""
 
     if check_deps; then
-        ok "deps: fswatch, yq installed"
+        ok "deps: ${DEPS[*]} installed"
     else
-        warn "deps: missing (run: setup deps)"
+        warn "deps: missing ${MISSING_DEPS[*]} (run: setup deps)"
+    fi
+
+    load_submodules
+    local i core=0 core_ready=0 community=0 community_ready=0
+    for i in "${!SUB_PATHS[@]}"; do
+        case "${SUB_PATHS[$i]}" in
+            skills/core/*)
+                core=$((core + 1))
+                submodule_ready "${SUB_PATHS[$i]}" && core_ready=$((core_ready + 1))
+                ;;
+            *)
+                community=$((community + 1))
+                submodule_ready "${SUB_PATHS[$i]}" && community_ready=$((community_ready + 1))
+                ;;
+        esac
+    done
+    if [ $core_ready -eq $core ]; then
+        ok "submodules: core $core_ready/$core, community $community_ready/$community (rest on first use)"
+    else
+        warn "submodules: core $core_ready/$core (run: setup submodules)"
     fi
 
     if check_shell; then
@@ -110,21 +225,59 @@ install_deps() {
         exit 1
     fi
 
-    if ! command -v fswatch >/dev/null 2>&1; then
-        echo "  Installing fswatch..."
-        brew install fswatch
-    else
-        ok "fswatch already installed"
+    missing_deps
+    if [ ${#MISSING_DEPS[@]} -eq 0 ]; then
+        ok "${DEPS[*]} already installed"
+        return 0
     fi
+    # One brew run for everything missing (brew serialises installs anyway)
+    echo "  Installing ${MISSING_DEPS[*]}..."
+    brew install "${MISSING_DEPS[@]}"
+    ok "Dependencies installed"
+}
 
-    if ! command -v yq >/dev/null 2>&1; then
-        echo "  Installing yq..."
-        brew install yq
-    else
-        ok "yq already installed"
+# install_submodules [--all] [--jobs N]
+install_submodules() {
+    local all=false i paths=()
+    while [ $# -gt 0 ]; do
+        case "$1" in
+            --all) all=true; shift ;;
+            --jobs|-j) SETUP_JOBS="$2"; shift 2 ;;
+            *) shift ;;
+        esac
+    done
+    echo "Initialising submodules..."
+    load_submodules
+    for i in "${!SUB_PATHS[@]}"; do
+        submodule_ready "${SUB_PATHS[$i]}" && continue
+        case "${SUB_PATHS[$i]}" in
+            skills/core/*) paths+=("${SUB_PATHS[$i]}") ;;
+            *) $all && paths+=("${SUB_PATHS[$i]}") ;;
+        esac
+    done
+    if [ ${#paths[@]} -eq 0 ]; then
+        ok "Submodules already initialised"
+        return 0
     fi
+    init_submodules "${paths[@]}"
+    ok "Initialised ${#paths[@]} submodule(s)"
+    $all || ok "Community skills are fetched on first use (zenix <skill>)"
+}
 
-    ok "Dependencies installed"
+# fetch_skill <name>... - init the submodules of the named skills
+fetch_skill() {
+    local name i paths=()
+    load_submodules
+    for name in "$@"; do
+        for i in "${!SUB_PATHS[@]}"; do
+            [ "${SUB_PATHS[$i]##*/}" = "$name" ] && paths+=("${SUB_PATHS[$i]}")
+        done
+    done
+    if [ ${#paths[@]} -eq 0 ]; then
+        err "No submodule for: $*"
+        return 1
+    fi
+    init_submodules "${paths[@]}"
 }
 
 install_shell() {
@@ -175,7 +328,19 @@ install_daemon() {
 install_all() {
     echo "=== Installing zenix ==="
     echo ""
-    install_deps
+    # brew and the submodule clones are independent: run them side by side
+    mkdir -p "$SETUP_LOGS"
+    install_deps > "$SETUP_LOGS/deps.log" 2>&1 &
+    local deps_pid=$!
+    install_submodules
+    echo ""
+    if wait "$deps_pid"; then
+        cat "$SETUP_LOGS/deps.log"
+    else
+        cat "$SETUP_LOGS/deps.log"
+        err "Dependency install failed (log: $SETUP_LOGS/deps.log)"
+        exit 1
+    fi
     echo ""
     install_shell
     echo ""
@@ -237,6 +402,14 @@ case "${1:-status}" in
     deps)
         install_deps
         ;;
+    submodules)
+        shift
+        install_submodules "$@"
+        ;;
+    fetch)
+        shift
+        fetch_skill "$@"
+        ;;
     shell)
         install_shell
         ;;
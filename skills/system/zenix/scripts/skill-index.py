@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""
+skill-index - Persistent index of skills and agents for zenix routing.
+
+Writes two files under $ZENIX_CACHE (default ~/.cache/zenix):
+
+    skills.json   {"skills": {name: record}, "agents": {name: record}}
+    skills.sh     flat shell variables, sourced by lib/skill-index.sh
+
+A skill record holds name, category, dir, run, env and the parsed SKILL.md
+frontmatter; an agent record holds name, skill, path and its frontmatter.
+
+Usage:
+    skill-index.py build              Rebuild from skills/*/*
+    skill-index.py update <path>...   Re-index only the skills containing <path>
+"""
+
+import glob
+import json
+import os
+import re
+import sys
+
+sys.dont_write_bytecode = True
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "../lib"))
+import config_cache  # noqa: E402
+
+ZENIX_ROOT = os.environ.get("ZENIX_ROOT", os.path.expanduser("~/.zenix"))
+SKILLS_DIR = os.path.join(ZENIX_ROOT, "skills")
+CACHE_DIR = os.environ.get("ZENIX_CACHE", os.path.expanduser("~/.cache/zenix"))
+INDEX_JSON = os.path.join(CACHE_DIR, "skills.json")
+INDEX_SH = os.path.join(CACHE_DIR, "skills.sh")
+
+
+def var_id(name: str) -> str:
+    """Same mangling as lib/skill-index.sh: ${name//[^a-zA-Z0-9]/_}"""
+    return re.sub(r"[^A-Za-z0-9]", "_", name)
+
+
+def frontmatter(path: str) -> dict:
+    try:
+        with open(path, encoding="utf-8", errors="replace") as f:
+            if f.readline().rstrip("\n") != "---":
+                return {}
+            lines = []
+            for line in f:
+                if line.rstrip("\n") == "---":
+                    break
+                lines.append(line)
+    except OSError:
+        return {}
+    data = config_cache.parse("".join(lines))
+    return data if isinstance(data, dict) else {}
+
+
+def index_skill(skill_dir: str) -> tuple:
+    """Records for one skills/<category>/<name> dir: (skill or None, [agents])."""
+    name = os.path.basename(skill_dir)
+    category = os.path.basename(os.path.dirname(skill_dir))
+    skill_md = os.path.join(skill_dir, "SKILL.md")
+    if not os.path.isfile(skill_md):
+        return None, []
+
+    run = os.path.join(skill_dir, "run")
+    env = os.path.join(skill_dir, "env")
+    skill = {
+        "name": name,
+        "category": category,
+        "dir": skill_dir,
+        "run": run if os.access(run, os.X_OK) else "",
+        "env": env if os.path.isfile(env) else "",
+        "frontmatter": frontmatter(skill_md),
+    }
+    agents = []
+    for path in sorted(glob.glob(os.path.join(skill_dir, "agents", "*.md"))):
+        agents.append({
+            "name": os.path.basename(path)[:-3],
+            "skill": name,
+            "category": category,
+            "path": path,
+            "frontmatter": frontmatter(path),
+        })
+    return skill, agents
+
+
+def build() -> dict:
+    index = {"skills": {}, "agents": {}}
+    for skill_dir in sorted(glob.glob(os.path.join(SKILLS_DIR, "*", "*"))):
+        add(index, *index_skill(skill_dir))
+    return index
+
+
+def add(index: dict, skill, agents: list):
+    # First one wins on duplicate names, matching glob order routing
+    if skill and skill["name"] not in index["skills"]:
+        index["skills"][skill["name"]] = skill
+    for agent in agents:
+        index["agents"].setdefault(agent["name"], agent)
+
+
+def update(paths: list) -> dict:
+    try:
+        with open(INDEX_JSON) as f:
+            index = json.load(f)
+    except (OSError, ValueError):
+        return build()
+
+    real_skills = os.path.realpath(SKILLS_DIR)
+    dirs = set()
+    for path in paths:
+        rel = os.path.relpath(os.path.realpath(path), real_skills).split(os.sep)
+        if len(rel) < 2 or rel[0] == "..":
+            continue
+        dirs.add(os.path.join(SKILLS_DIR, rel[0], rel[1]))
+
+    for skill_dir in sorted(dirs):
+        # Drop the old records of this dir, then re-add whatever is there now
+        index["skills"] = {k: v for k, v in index["skills"].items() if v["dir"] != skill_dir}
+        index["agents"] = {k: v for k, v in index["agents"].items()
+                           if os.path.dirname(os.path.dirname(v["path"])) != skill_dir}
+        add(index, *index_skill(skill_dir))
+
+    # Keep glob order so listing stays grouped by category
+    index["skills"] = dict(sorted(index["skills"].items(), key=lambda kv: kv[1]["dir"]))
+    index["agents"] = dict(sorted(index["agents"].items(), key=lambda kv: kv[1]["path"]))
+    return index
+
+
+def description(record: dict) -> str:
+    desc = record["frontmatter"].get("description")
+    return "" if desc is None else str(desc)
+
+
+def render_sh(index: dict) -> str:
+    q = config_cache.shell_quote
+    lines = ["# Generated by skill-index.py"]
+    lines.append("ZENIX_SKILL_NAMES=" + q(" ".join(index["skills"])))
+    for name, s in index["skills"].items():
+        v = "zs_" + var_id(name)
+        lines.append(f"{v}_category={q(s['category'])}")
+        lines.append(f"{v}_dir={q(s['dir'])}")
+        lines.append(f"{v}_run={q(s['run'])}")
+        lines.append(f"{v}_env={q(s['env'])}")
+        lines.append(f"{v}_desc={q(description(s))}")
+    lines.append("ZENIX_AGENT_NAMES=" + q(" ".join(index["agents"])))
+    for name, a in index["agents"].items():
+        v = "za_" + var_id(name)
+        lines.append(f"{v}_skill={q(a['skill'])}")
+        lines.append(f"{v}_path={q(a['path'])}")
+        lines.append(f"{v}_desc={q(description(a))}")
+        lines.append(f"{v}_pool={q(a['frontmatter'].get('pool', ''))}")
+    return "\n".join(lines) + "\n"
+
+
+def write(index: dict):
+    os.makedirs(CACHE_DIR, exist_ok=True)
+    for path, content in ((INDEX_JSON, json.dumps(index, indent=1)), (INDEX_SH, render_sh(index))):
+        tmp = f"{path}.{os.getpid()}.tmp"
+        with open(tmp, "w") as f:
+            f.write(content)
+        os.replace(tmp, path)
+
+
+def main():
+    if len(sys.argv) == 2 and sys.argv[1] == "build":
+        index = build()
+    elif len(sys.argv) >= 3 and sys.argv[1] == "update":
+        index = update(sys.argv[2:])
+    else:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+    write(index)
+    print(f"Indexed {len(index['skills'])} skills, {len(index['agents'])} agents")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+stats - Summarise watcher and agent run metrics (see lib/metrics.py).
+
+Usage:
+    stats.py [summary] [--since 7d] [--watcher <name>]   Actions, agent runs and spend
+    stats.py export [file]                               Write the OpenMetrics textfile
+    stats.py tail [n]                                    Last n raw records (default 20)
+
+--since takes 30m, 24h, 7d (default 7d). Durations are p50/p95 of the
+records in that window; counters in the export cover everything recorded
+(rotated generations are kept in totals.json).
+"""
+
+import os
+import re
+import sys
+import time
+
+sys.dont_write_bytecode = True
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "../lib"))
+import metrics  # noqa: E402
+
+UNITS = {"m": 60, "h": 3600, "d": 86400, "w": 7 * 86400}
+
+
+def parse_since(text: str) -> int:
+    m = re.fullmatch(r"(\d+)([mhdw])", text)
+    if not m:
+        raise ValueError(text)
+    return int(time.time()) - int(m.group(1)) * UNITS[m.group(2)]
+
+
+def percentile(values: list, p: float) -> float:
+    values = sorted(values)
+    return values[min(len(values) - 1, int(round(p / 100 * (len(values) - 1))))]
+
+
+def duration(ms: float) -> str:
+    if ms < 1000:
+        return f"{ms:.0f}ms"
+    if ms < 60000:
+        return f"{ms / 1000:.1f}s"
+    return f"{ms / 60000:.1f}m"
+
+
+def tokens(n: float) -> str:
+    if n >= 1_000_000:
+        return f"{n / 1_000_000:.1f}M"
+    if n >= 1000:
+        return f"{n / 1000:.0f}k"
+    return f"{n:.0f}"
+
+
+def cmd_summary(since: int, watcher: str, label: str):
+    actions, skips, agents, spend = {}, {}, {}, {}
+    for _, event, name, f in metrics.records(since):
+        if event == "action" and (not watcher or name == watcher):
+            a = actions.setdefault((name, f.get("act", "")), {"ms": [], "wait": [], "fail": 0})
+            a["ms"].append(metrics.number(f, "ms"))
+            if "wait" in f:
+                a["wait"].append(metrics.number(f, "wait"))
+            if f.get("exit") != "0":
+                a["fail"] += 1
+        elif event == "skip" and (not watcher or name == watcher):
+            skips[name] = skips.get(name, 0) + 1
+        elif event == "agent" and (not watcher or f.get("watcher") == watcher):
+            a = agents.setdefault((name, f.get("model", "")), {"ms": [], "fail": 0, "in": 0, "out": 0, "cost": 0.0})
+            a["ms"].append(metrics.number(f, "ms"))
+            if f.get("status") != "ok":
+                a["fail"] += 1
+            for key in ("in", "out", "cost"):
+                a[key] += metrics.number(f, key)
+            s = spend.setdefault(f.get("watcher", "-"), {"runs": 0, "tokens": 0, "cost": 0.0})
+            s["runs"] += 1
+            s["tokens"] += sum(metrics.number(f, k) for k in ("in", "out", "cache_read", "cache_write"))
+            s["cost"] += metrics.number(f, "cost")
+
+    if not actions and not agents:
+        print(f"No metrics {label}. Records are written by watcherd and headless agent runs")
+        print(f"to {metrics.LOG_FILE}")
+        return
+
+    if actions:
+        print(f"Watcher actions {label}")
+        print(f"{'WATCHER':<22} {'ACTION':<18} {'RUNS':>5} {'FAIL':>5} {'P50':>7} {'P95':>7} "
+              f"{'WAIT':>7} {'SKIP':>5}")
+        for (name, act), a in sorted(actions.items()):
+            wait = duration(percentile(a["wait"], 50)) if a["wait"] else "-"
+            print(f"{name:<22} {act:<18} {len(a['ms']):>5} {a['fail']:>5} "
+                  f"{duration(percentile(a['ms'], 50)):>7} {duration(percentile(a['ms'], 95)):>7} "
+                  f"{wait:>7} {skips.get(name, 0):>5}")
+    if agents:
+        print()
+        print(f"Agent runs {label}")
+        print(f"{'AGENT':<22} {'MODEL':<10} {'RUNS':>5} {'FAIL':>5} {'P50':>7} {'P95':>7} "
+              f"{'IN':>7} {'OUT':>7} {'COST':>8}")
+        for (name, model), a in sorted(agents.items()):
+            print(f"{name:<22} {model:<10} {len(a['ms']):>5} {a['fail']:>5} "
+                  f"{duration(percentile(a['ms'], 50)):>7} {duration(percentile(a['ms'], 95)):>7} "
+                  f"{tokens(a['in']):>7} {tokens(a['out']):>7} {a['cost']:>8.3f}")
+        print()
+        print(f"{'SPEND BY WATCHER':<22} {'RUNS':>5} {'TOKENS':>8} {'COST':>8}")
+        for name, s in sorted(spend.items(), key=lambda kv: -kv[1]["cost"]):
+            print(f"{name:<22} {s['runs']:>5} {tokens(s['tokens']):>8} {s['cost']:>8.3f}")
+
+
+def cmd_export(path: str):
+    reader = metrics.Reader()
+    reader.rebuild()
+    metrics.write_textfile(reader.tally, path)
+    print(path)
+
+
+def cmd_tail(n: int):
+    lines = []
+    for path in reversed(metrics.generations()):
+        with open(path, "rb") as f:
+            lines = f.read().decode("utf-8", "replace").splitlines()[-n:] + lines
+        if len(lines) >= n:
+            break
+    for line in lines[-n:]:
+        print(line)
+
+
+def main():
+    args = sys.argv[1:]
+    command = args.pop(0) if args and not args[0].startswith("-") else "summary"
+    if command == "export":
+        cmd_export(args[0] if args else metrics.TEXTFILE)
+        return
+    if command == "tail":
+        cmd_tail(int(args[0]) if args else 20)
+        return
+    since_text, watcher = "7d", ""
+    try:
+        while args:
+            if args[0] == "--since" and len(args) > 1:
+                since_text, args = args[1], args[2:]
+            elif args[0] == "--watcher" and len(args) > 1:
+                watcher, args = args[1], args[2:]
+            else:
+                raise ValueError(args[0])
+        since = parse_since(since_text)
+    except ValueError:
+        command = ""
+    if command != "summary":
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+    cmd_summary(since, watcher, f"(last {since_text})")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""
+trace - Summarise zenix startup traces (ZENIX_TRACE=1, see lib/trace.sh).
+
+Usage:
+    trace.py [summary] [-n N] [--cmd <substr>]   Time per stage over the last N runs (default 20)
+    trace.py last [--cmd <substr>]               Timeline of the most recent run
+    trace.py runs [-n N] [--cmd <substr>]        One line per run: total and slowest stage
+    trace.py clear                               Delete the trace file
+
+Stages appear in the order the chain reaches them; p50/p90/max are in
+milliseconds, share is the stage's part of the median total.
+"""
+
+import json
+import os
+import sys
+
+TRACE_FILE = os.environ.get("ZENIX_TRACE_FILE") or os.path.join(
+    os.environ.get("XDG_STATE_HOME") or os.path.expanduser("~/.local/state"), "zenix", "trace.jsonl")
+
+
+def load_runs(cmd_filter: str = "") -> list:
+    """[{"run", "cmd", "spans": [(stage, start, end)]}] in file order."""
+    runs, by_id = [], {}
+    try:
+        with open(TRACE_FILE) as f:
+            for line in f:
+                try:
+                    span = json.loads(line)
+                except ValueError:
+                    continue
+                run = by_id.get(span["run"])
+                if run is None:
+                    run = by_id[span["run"]] = {"run": span["run"], "cmd": span.get("cmd", ""), "spans": []}
+                    runs.append(run)
+                run["spans"].append((span["stage"], float(span["start"]), float(span["end"])))
+    except FileNotFoundError:
+        pass
+    if cmd_filter:
+        runs = [r for r in runs if cmd_filter in r["cmd"]]
+    return runs
+
+
+def ms(seconds: float) -> float:
+    return seconds * 1000
+
+
+def percentile(values: list, p: float) -> float:
+    values = sorted(values)
+    return values[min(len(values) - 1, int(round(p / 100 * (len(values) - 1))))]
+
+
+def total(run: dict) -> float:
+    spans = run["spans"]
+    return spans[-1][2] - spans[0][1]
+
+
+def cmd_summary(runs: list):
+    stages, times = [], {}
+    for run in runs:
+        for stage, start, end in run["spans"]:
+            if stage not in times:
+                stages.append(stage)
+                times[stage] = []
+            times[stage].append(ms(end - start))
+    totals = [ms(total(r)) for r in runs]
+    median_total = percentile(totals, 50) or 1.0
+    print(f"{len(runs)} run(s) from {TRACE_FILE}")
+    print(f"{'stage':<22} {'runs':>5} {'p50':>8} {'p90':>8} {'max':>8} {'share':>6}")
+    for stage in stages:
+        t = times[stage]
+        p50 = percentile(t, 50)
+        print(f"{stage:<22} {len(t):>5} {p50:>8.1f} {percentile(t, 90):>8.1f} {max(t):>8.1f} "
+              f"{p50 / median_total * 100:>5.0f}%")
+    print(f"{'total':<22} {len(totals):>5} {median_total:>8.1f} {percentile(totals, 90):>8.1f} "
+          f"{max(totals):>8.1f}")
+
+
+def cmd_last(run: dict):
+    origin = run["spans"][0][1]
+    print(f"{run['cmd']}  ({run['run']})")
+    for stage, start, end in run["spans"]:
+        print(f"  +{ms(start - origin):>8.1f}  {stage:<22} {ms(end - start):>8.1f} ms")
+    print(f"  total {ms(total(run)):.1f} ms")
+
+
+def cmd_runs(runs: list):
+    for run in runs:
+        stage, start, end = max(run["spans"], key=lambda s: s[2] - s[1])
+        print(f"{run['run']}  {ms(total(run)):>8.1f} ms  slowest {stage} {ms(end - start):.1f} ms  {run['cmd']}")
+
+
+def main():
+    args = sys.argv[1:]
+    command = args.pop(0) if args and not args[0].startswith("-") else "summary"
+    limit, cmd_filter = 20, ""
+    while args:
+        if args[0] == "-n" and len(args) > 1:
+            limit, args = int(args[1]), args[2:]
+        elif args[0] == "--cmd" and len(args) > 1:
+            cmd_filter, args = args[1], args[2:]
+        else:
+            print(__doc__.strip(), file=sys.stderr)
+            sys.exit(1)
+
+    if command == "clear":
+        try:
+            os.remove(TRACE_FILE)
+        except FileNotFoundError:
+            pass
+        print("Trace cleared")
+        return
+    if command not in ("summary", "last", "runs"):
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+
+    runs = load_runs(cmd_filter)
+    if not runs:
+        print("No traces yet. Run a command with ZENIX_TRACE=1, e.g.:")
+        print("  ZENIX_TRACE=1 zenix agent -A heartbeat")
+        return
+    if command == "last":
+        cmd_last(runs[-1])
+    elif command == "runs":
+        cmd_runs(runs[-limit:])
+    else:
+        cmd_summary(runs[-limit:])
+
+
+if __name__ == "__main__":
+    main()